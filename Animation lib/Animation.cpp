@@ -169,8 +169,7 @@ void Anisprite::updateSprite(int t)
 
 void Anisprite::loopUpdate()
 {
-	_clock.timer->Update();
-	float ctime = float(_clock.timer->GetTime().asSec() - _clock.stime);
+	float ctime = float((_clock.now() - _clock.stime).asSec());
 	int t = int(floor(ctime * projections[cur_proj].animations[cur_anim].FPS)) % projections[cur_proj].animations[cur_anim].length;
 	updateSprite(t);
 }
@@ -224,13 +223,13 @@ void Anisprite::setplayback(int n, int m)
 {
 	switchProj(n);
 	switchAnim(m);
-	_clock.stime = _clock.timer->Update();
+	_clock.stime = _clock.now();
 }
 
 void Anisprite::setplayback(int n)
 {
 	cur_anim = n;
-	_clock.stime = _clock.timer->Update();
+	_clock.stime = _clock.now();
 }
 
 void Anisprite::loadFromFile(std::string data, std::string source)
@@ -13,16 +13,22 @@
 //#include <sqlite3.h> // for DB loading - disabled for now
 
 /*=================================================================================================
-* Struct Aniclock - wrapper structure for Perspective::Timer;
-* Used to get elapsed time from Timer object;
-* Stores playback start timel
+* Struct Aniclock - playback clock of an Anisprite;
+* Reads Perspective::FrameClock snapshot by default, so all sprites of a frame share one clock reading
+* and updating a sprite costs no clock call nor virtual dispatch;
+* The frame loop must call Perspective::FrameClock::Tick() once per frame;
+* A sprite paused or slowed on its own gets a timer of its own with init_timer()
+* (a Perspective::FrameTimer keeps the shared reading);
+* Stores playback start time;
 * May require a better name;
 */
 
 struct Aniclock
 {
 	Perspective::Duration stime = 0;
-	Perspective::Timer * timer = nullptr;
+	Perspective::Timer * timer = nullptr; // nullptr - FrameClock
+
+	Perspective::Duration now() { return timer ? timer->Update() : Perspective::FrameClock::now(); }
 };
 
 
@@ -126,7 +132,7 @@ public:
 	//Initialisation and loading functions:
 	void init(int n, std::string source);
 	void init(int n);
-	void init_timer(Perspective::Timer * t);
+	void init_timer(Perspective::Timer * t); // per-sprite clock, nullptr - FrameClock
 	void loadFromFile(std::string data, std::string source);
 	void loadFromMemory(char * mdata);
 	void loadFromDB(int &len, char * data);
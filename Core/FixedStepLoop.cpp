@@ -0,0 +1,63 @@
+/* FixedStepLoop Realizations
+ * Depends on Perspective::Timer.hpp, Perspective::TimeUtils.hpp
+ */
+
+#include "FixedStepLoop.hpp"
+
+namespace Perspective
+{
+
+    FixedStepLoop::FixedStepLoop( const Duration& StepT, const Duration& RenderPer, unsigned MaxStepsPerFrame, bool Prec )
+        : Step( StepT > ZERO_Duration ? StepT : SMALLEST_Duration ),
+        RenderPeriod( RenderPer > ZERO_Duration ? RenderPer : ZERO_Duration ),
+        MaxSteps( MaxStepsPerFrame ? MaxStepsPerFrame : 1 ),
+        Precise( Prec )
+    {
+        FrameT.Start();
+    }
+
+    void FixedStepLoop::Reset()
+    {
+        Accumulator = ZERO_Duration;
+        NextRender = ZERO_Duration;
+        FrameT.Restart();
+    }
+
+    unsigned FixedStepLoop::_Consume( const Duration& Delta )
+    {
+        if (Delta > ZERO_Duration)
+            Accumulator += Delta;
+        time_tick_t N = Accumulator.getTicks() / Step.getTicks();
+        if (N > time_tick_t( MaxSteps ))
+        {
+            Dropped += Duration( (N - MaxSteps) * Step.getTicks() );
+            N = MaxSteps;
+        }
+        Accumulator = Accumulator % Step;
+        return unsigned( N );
+    }
+
+    bool FixedStepLoop::_RenderDue( const Duration& Now )
+    {
+        if (RenderPeriod == ZERO_Duration)
+            return true;
+        if (Now < NextRender)
+            return false;
+        NextRender += RenderPeriod;
+        if (NextRender <= Now)  // missed renders are not repeated
+            NextRender = Now + RenderPeriod;
+        return true;
+    }
+
+    void FixedStepLoop::_Wait( bool Headless )
+    {
+        Duration Wake = FrameT.GetLast() + Step - Accumulator;  // next step is due
+        if (!Headless && NextRender < Wake)
+            Wake = NextRender;
+        if (Precise)
+            PreciseSleepUntil( Wake );
+        else
+            SleepUntil( Wake );
+    }
+
+}
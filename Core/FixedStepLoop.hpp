@@ -0,0 +1,132 @@
+/*
+* Perspective module for fixed-timestep main loops.
+* Simulation advances in equal steps accumulated from real frame time, so it
+* runs identically on a dedicated server and on a client. Rendering runs at
+* its own rate and gets interpolation alpha between the last two simulation
+* states. Long frames (debugger, load hitch) are capped to avoid the spiral
+* of death: the excess is dropped and simulation runs slower than real time.
+* Depends on Perspective::Timer.hpp, Perspective::TimeUtils.hpp
+*/
+
+#pragma once
+
+// Standart dependencies: <atomic>
+#include <atomic>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+#include "TimeUtils.hpp"
+
+namespace Perspective
+{
+// ============================ FixedStepLoop ===============================
+
+    // Class FixedStepLoop - drives Simulate( Step ) at a fixed rate and
+    // Render( Alpha ) at a decoupled rate. Either runs the loop by itself
+    // (Run, RunHeadless) or is stepped from an external loop (Frame, Advance).
+    // Not thread-safe except Stop().
+    class FixedStepLoop
+    {
+    protected:
+        Timer FrameT;  // real time of the current frame, restarted every frame
+        Duration Step;  // simulation step
+        Duration RenderPeriod;  // minimal interval between renders. ZERO_Duration - every frame
+        Duration Accumulator{ ZERO_Duration };  // real time not yet simulated, less than Step after a frame
+        Duration SimTime{ ZERO_Duration };  // simulated time
+        Duration NextRender{ ZERO_Duration };  // moment of the next render (duration since program start)
+        Duration Dropped{ ZERO_Duration };  // real time dropped by the spiral of death cap
+        uint64_t Steps = 0;  // total amount of simulation steps
+        uint64_t Renders = 0;  // total amount of renders
+        unsigned MaxSteps;  // simulation steps per frame cap
+        bool Precise;  // use hybrid precise sleep between frames
+        std::atomic<bool> Running{ false };  // inside Run or RunHeadless
+        std::atomic<bool> StopRequested{ false };  // consumed by Run on exit
+
+        unsigned _Consume( const Duration& Delta );  // adds real interval to the accumulator, returns amount of steps due
+        bool _RenderDue( const Duration& Now );  // true if it is time to render, schedules the next render
+        void _Wait( bool Headless );  // sleeps until the next step or render
+    public:
+        // StepT - simulation step, RenderPer - minimal interval between
+        // renders (ZERO_Duration - render every frame, e.g. throttled by vsync),
+        // MaxStepsPerFrame - spiral of death cap. Starts measuring real time
+        explicit FixedStepLoop( const Duration& StepT, const Duration& RenderPer = ZERO_Duration,
+            unsigned MaxStepsPerFrame = 8, bool Prec = true );
+
+        // consumes Delta of real time: calls Simulate( Step ) for every whole
+        // step accumulated, at most MaxSteps times. Returns amount of steps
+        template<class SimulateF>
+        unsigned Advance( const Duration& Delta, SimulateF&& Simulate )
+        {
+            unsigned N = _Consume( Delta );
+            for (unsigned i = 0; i < N; i++)
+            {
+                Simulate( Step );
+                SimTime += Step;
+                Steps++;
+            }
+            return N;
+        }
+
+        // single iteration for external loops: simulates real time passed
+        // since the previous frame, then calls Render( Alpha ) if it is due
+        template<class SimulateF, class RenderF>
+        unsigned Frame( SimulateF&& Simulate, RenderF&& Render )
+        {
+            unsigned N = Advance( FrameT.Restart(), Simulate );
+            if (_RenderDue( FrameT.GetLast() ))
+            {
+                Render( GetAlpha() );
+                Renders++;
+            }
+            return N;
+        }
+
+        // runs frames until Stop(). Sleeps between frames if RenderPeriod is set
+        template<class SimulateF, class RenderF>
+        void Run( SimulateF&& Simulate, RenderF&& Render )
+        {
+            Running.store( true, std::memory_order_relaxed );
+            Reset();
+            while (!StopRequested.load( std::memory_order_relaxed ))
+            {
+                Frame( Simulate, Render );
+                if (RenderPeriod != ZERO_Duration)
+                    _Wait( false );
+            }
+            StopRequested.store( false, std::memory_order_relaxed );
+            Running.store( false, std::memory_order_relaxed );
+        }
+
+        // runs simulation only until Stop(), sleeping between steps. For servers
+        template<class SimulateF>
+        void RunHeadless( SimulateF&& Simulate )
+        {
+            Running.store( true, std::memory_order_relaxed );
+            Reset();
+            while (!StopRequested.load( std::memory_order_relaxed ))
+            {
+                Advance( FrameT.Restart(), Simulate );
+                _Wait( true );
+            }
+            StopRequested.store( false, std::memory_order_relaxed );
+            Running.store( false, std::memory_order_relaxed );
+        }
+
+        // finishes Run after the current frame. Any thread. If called before
+        // Run, the next Run returns immediately
+        inline void Stop() { StopRequested.store( true, std::memory_order_relaxed ); }
+        void Reset();  // drops accumulated time and restarts real time measuring. Keeps counters
+
+        // fraction of the next step already passed in real time, [0, 1).
+        // Render state as Previous + (Current - Previous) * Alpha
+        inline double GetAlpha() const { return Accumulator / Step; }
+
+        inline bool IsRunning() const { return Running.load( std::memory_order_relaxed ); }
+        inline const Duration& GetStep() const { return Step; }
+        inline const Duration& GetRenderPeriod() const { return RenderPeriod; }
+        inline const Duration& GetSimTime() const { return SimTime; }  // simulated time
+        inline const Duration& GetDropped() const { return Dropped; }  // real time lost to the cap
+        inline uint64_t GetStepCount() const { return Steps; }
+        inline uint64_t GetRenderCount() const { return Renders; }
+    };
+}
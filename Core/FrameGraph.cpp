@@ -0,0 +1,164 @@
+/* FrameGraph Realizations
+ * Depends on Perspective::Timer.hpp, Perspective::JobSystem.hpp,
+ * Perspective::Profiler.hpp, <algorithm>
+ */
+
+#include "FrameGraph.hpp"
+#include "Profiler.hpp"
+
+// Standart dependencies: <algorithm>
+#include <algorithm>
+
+namespace Perspective
+{
+
+    FrameGraph::ResourceId FrameGraph::AddResource( const char* Name )
+    {
+        Resources.push_back( Name );
+        return ResourceId( Resources.size() - 1 );
+    }
+
+    FrameGraph::NodeId FrameGraph::AddNode( const char* Name, NodeFunction Work,
+        std::initializer_list<ResourceId> Reads, std::initializer_list<ResourceId> Writes )
+    {
+        Nodes.emplace_back( new _Node );
+        _Node& N = *Nodes.back();
+        N.Name = Name;
+        N.Work = std::move( Work );
+        N.Reads.assign( Reads );
+        N.Writes.assign( Writes );
+        Compiled = false;
+        return NodeId( Nodes.size() - 1 );
+    }
+
+    void FrameGraph::Compile()
+    {
+        const NodeId NONE = NodeId( -1 );
+        std::vector<NodeId> LastWriter( Resources.size(), NONE );
+        std::vector<std::vector<NodeId>> Readers( Resources.size() );  // of the current value
+
+        for (std::unique_ptr<_Node>& N : Nodes)
+        {
+            N->Dependencies.clear();
+            N->Dependents.clear();
+        }
+
+        // replay the serial order: read after write, write after read and
+        // write after write become edges
+        for (NodeId i = 0; i < Nodes.size(); i++)
+        {
+            _Node& N = *Nodes[i];
+            for (ResourceId R : N.Reads)
+                if (LastWriter[R] != NONE && LastWriter[R] != i)
+                    N.Dependencies.push_back( LastWriter[R] );
+            for (ResourceId R : N.Writes)
+            {
+                if (LastWriter[R] != NONE && LastWriter[R] != i)
+                    N.Dependencies.push_back( LastWriter[R] );
+                for (NodeId Reader : Readers[R])
+                    if (Reader != i)
+                        N.Dependencies.push_back( Reader );
+            }
+            for (ResourceId R : N.Reads)
+                Readers[R].push_back( i );
+            for (ResourceId R : N.Writes)
+            {
+                LastWriter[R] = i;
+                Readers[R].clear();
+            }
+
+            std::sort( N.Dependencies.begin(), N.Dependencies.end() );
+            N.Dependencies.erase( std::unique( N.Dependencies.begin(), N.Dependencies.end() ), N.Dependencies.end() );
+            for (NodeId D : N.Dependencies)
+                Nodes[D]->Dependents.push_back( i );
+        }
+
+        Roots.clear();
+        for (NodeId i = 0; i < Nodes.size(); i++)
+            if (Nodes[i]->Dependencies.empty())
+                Roots.push_back( i );
+        Compiled = true;
+    }
+
+    size_t FrameGraph::GetEdgeCount() const
+    {
+        size_t Edges = 0;
+        for (const std::unique_ptr<_Node>& N : Nodes)
+            Edges += N->Dependencies.size();
+        return Edges;
+    }
+
+    void FrameGraph::Execute()
+    {
+        if (!Compiled)
+            Compile();
+        for (std::unique_ptr<_Node>& N : Nodes)
+            N->Pending.store( uint32_t( N->Dependencies.size() ), std::memory_order_relaxed );
+
+        FrameT.Restart();
+        FrameJob = Jobs.Create( [] {} );
+        for (NodeId i : Roots)
+            Jobs.Run( Jobs.Create( [this, i] { _Run( i ); }, FrameJob ) );
+        Jobs.Run( FrameJob );
+        Jobs.Wait( FrameJob );
+        FrameT.Stop();
+        FrameJob = nullptr;
+        _Analyze();
+    }
+
+    void FrameGraph::_Run( NodeId i )
+    {
+        _Node& N = *Nodes[i];
+        Duration Now = ProgramTime();
+        N.Began = Now - FrameT.GetStart();
+        N.Clock.RestartAt( Now );
+        {
+            ProfileScope Zone( N.Name );
+            N.Work();
+        }
+        N.Clock.StopAt( ProgramTime() );
+
+        for (NodeId D : N.Dependents)
+            if (Nodes[D]->Pending.fetch_sub( 1, std::memory_order_acq_rel ) == 1)
+                Jobs.Spawn( [this, D] { _Run( D ); }, FrameJob );  // the last dependency releases it
+    }
+
+    void FrameGraph::_Analyze()
+    {
+        // declaration order is a topological order
+        NodeId Last = 0;
+        CriticalT = ZERO_Duration;
+        for (NodeId i = 0; i < Nodes.size(); i++)
+        {
+            _Node& N = *Nodes[i];
+            Duration Start = ZERO_Duration;
+            for (NodeId D : N.Dependencies)
+                if (Nodes[D]->PathEnd > Start)
+                    Start = Nodes[D]->PathEnd;
+            N.PathEnd = Start + N.Clock.GetTime();
+            if (N.PathEnd > CriticalT)
+            {
+                CriticalT = N.PathEnd;
+                Last = i;
+            }
+        }
+
+        CriticalPath.clear();
+        if (Nodes.empty())
+            return;
+        for (NodeId i = Last;;)
+        {
+            CriticalPath.push_back( i );
+            const _Node& N = *Nodes[i];
+            if (N.Dependencies.empty())
+                break;
+            NodeId Longest = N.Dependencies[0];
+            for (NodeId D : N.Dependencies)
+                if (Nodes[D]->PathEnd > Nodes[Longest]->PathEnd)
+                    Longest = D;
+            i = Longest;
+        }
+        std::reverse( CriticalPath.begin(), CriticalPath.end() );
+    }
+
+}
@@ -0,0 +1,100 @@
+/*
+* Perspective module for per-frame task graphs.
+* Systems (input, simulation, animation, culling, render preparation...) are
+* added as nodes declaring resources they read and write. The order of
+* declaration is the serial order of the frame: a node depends on the last
+* writer of every resource it reads, and a writer also waits for readers of
+* the previous value. The graph is compiled once and reused every frame;
+* independent nodes run concurrently on a JobSystem.
+* Every frame is timed with Perspective timers: frame time, time of every
+* node and the critical path - the longest chain of dependent nodes, which
+* bounds the frame time on any amount of cores.
+* Depends on Perspective::Timer.hpp, Perspective::JobSystem.hpp,
+* Perspective::Profiler.hpp, <vector>
+*/
+
+#pragma once
+
+// Standart dependencies: <atomic>, <functional>, <initializer_list>, <memory>, <vector>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+#include "JobSystem.hpp"
+
+namespace Perspective
+{
+// ============================== FrameGraph ================================
+
+    // Class FrameGraph - dependency graph of frame systems. Building (Add*,
+    // Compile) and Execute are called by a single thread; node functions run
+    // on workers of the JobSystem and may use it for nested parallelism.
+    class FrameGraph
+    {
+    public:
+        typedef uint32_t ResourceId;
+        typedef uint32_t NodeId;
+        typedef std::function<void()> NodeFunction;
+
+    protected:
+        struct _Node
+        {
+            const char* Name;  // also name of its profiling zone, must outlive the graph
+            NodeFunction Work;
+            std::vector<ResourceId> Reads, Writes;
+            std::vector<NodeId> Dependencies;  // nodes to finish first, sorted
+            std::vector<NodeId> Dependents;  // nodes waiting for this one
+            std::atomic<uint32_t> Pending{ 0 };  // unfinished dependencies in the current frame
+            StopwatchTimer<> Clock;  // time of the node in the last frame
+            Duration Began;  // start of the node in the last frame, since frame start
+            Duration PathEnd;  // end of the longest chain ending with this node
+        };
+
+        JobSystem& Jobs;
+        std::vector<const char*> Resources;  // names
+        std::vector<std::unique_ptr<_Node>> Nodes;  // in declaration (serial) order
+        std::vector<NodeId> Roots;  // nodes without dependencies
+        bool Compiled = false;
+
+        Timer FrameT;  // time of the last frame
+        JobSystem::JobHandle FrameJob = nullptr;  // parent of node jobs of the running frame
+        std::vector<NodeId> CriticalPath;
+        Duration CriticalT{ ZERO_Duration };
+
+        void _Run( NodeId N );  // executes a node and releases its dependents
+        void _Analyze();  // critical path of the last frame
+    public:
+        explicit FrameGraph( JobSystem& JS ) : Jobs( JS ) {}
+
+        FrameGraph( const FrameGraph& ) = delete;
+        FrameGraph& operator= ( const FrameGraph& ) = delete;
+
+        ResourceId AddResource( const char* Name );
+        // adds a system after all added ones. Name must outlive the graph
+        NodeId AddNode( const char* Name, NodeFunction Work,
+            std::initializer_list<ResourceId> Reads, std::initializer_list<ResourceId> Writes );
+
+        void Compile();  // builds dependencies. Called by Execute after changes
+        void Execute();  // runs all nodes once and waits for them
+
+        inline size_t GetNodeCount() const { return Nodes.size(); }
+        size_t GetEdgeCount() const;
+        inline const char* GetNodeName( NodeId N ) const { return Nodes[N]->Name; }
+        inline const std::vector<NodeId>& GetDependencies( NodeId N ) const { return Nodes[N]->Dependencies; }
+
+// ------------------------ Timings of the last frame -----------------------
+
+        inline Duration GetFrameTime() const { return FrameT.GetTime(); }
+        inline Duration GetNodeTime( NodeId N ) const { return Nodes[N]->Clock.GetTime(); }
+        inline Duration GetNodeStart( NodeId N ) const { return Nodes[N]->Began; }  // since frame start
+        // sum of node times along the longest dependency chain. The frame
+        // can't be faster than this; the gap to GetFrameTime() is scheduling
+        // overhead and waiting for free workers
+        inline Duration GetCriticalPathTime() const { return CriticalT; }
+        inline const std::vector<NodeId>& GetCriticalPath() const { return CriticalPath; }  // from the first node
+    };
+}
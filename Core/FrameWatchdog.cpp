@@ -0,0 +1,161 @@
+/* FrameWatchdog Realizations
+ * Depends on Perspective::Timer.hpp, Perspective::TimeUtils.hpp,
+ * Perspective::Profiler.hpp, Perspective::TimeFormat.hpp
+ */
+
+#include "FrameWatchdog.hpp"
+#include "TimeFormat.hpp"
+
+// Standart dependencies: <ostream>
+#include <ostream>
+
+namespace Perspective
+{
+
+    FrameWatchdog::FrameWatchdog( const Duration& StallThreshold, size_t Capacity )
+        : Reports( Capacity ? Capacity : 1 )
+    {
+        SetThreshold( StallThreshold );
+    }
+
+    void FrameWatchdog::SetThreshold( const Duration& StallThreshold )
+    {
+        Threshold = StallThreshold > millisec( 1 ) ? StallThreshold : millisec( 1 );
+        Period = Duration( Threshold.getTicks() / 4 );  // a stall is caught within 1.25 of the threshold
+    }
+
+    void FrameWatchdog::SetHandler( StallHandler H, void* User )
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        Handler = H;
+        HandlerData = User;
+    }
+
+    void FrameWatchdog::Start()
+    {
+        if (Running.exchange( true ))
+            return;
+        Watched = std::this_thread::get_id();
+        WatchedTid = IsProfilerEnabled() ? ProfileThreadId() : 0;
+        Wake.Reset();
+        Heartbeat();
+        Worker = std::thread( &FrameWatchdog::_Watch, this );
+    }
+
+    void FrameWatchdog::Stop()
+    {
+        if (!Running.exchange( false ))
+            return;
+        Wake.Set();
+        Worker.join();
+    }
+
+    void FrameWatchdog::_Capture( time_tick_t B, const Duration& Now )
+    {
+        StallReport R;
+        R.Moment = GlobalTime();
+        R.Began = Duration( B );
+        R.Length = Now - R.Began;
+        R.Thread = Watched;
+        R.ProfileTid = WatchedTid;
+        R.Depth = WatchedTid ? uint32_t( ReadProfileStack( WatchedTid, R.Zones, PROFILE_STACK_DEPTH ) ) : 0;
+        R.Ongoing = true;
+
+        StallHandler H;
+        void* User;
+        {
+            std::lock_guard<std::mutex> Lock( Guard );
+            Reports[Stalls % Reports.size()] = R;
+            Stalls++;
+            H = Handler;
+            User = HandlerData;
+        }
+        if (H)
+            H( R, User );
+    }
+
+    void FrameWatchdog::_Watch()
+    {
+        time_tick_t Reported = MIN_TICK;  // heartbeat of the open report
+        bool Open = false;  // the latest report is ongoing
+        while (Running.load( std::memory_order_relaxed ))
+        {
+            Wake.WaitFor( Period );
+            time_tick_t B = Beat.load( std::memory_order_relaxed );
+            Duration Now = ProgramTime();
+
+            if (Open)
+            {
+                std::lock_guard<std::mutex> Lock( Guard );
+                StallReport& R = Reports[(Stalls - 1) % Reports.size()];
+                if (Stalls == 0)  // cleared meanwhile
+                    Open = false;
+                else if (B != Reported)  // stall is over: the frame took from heartbeat to heartbeat
+                {
+                    R.Length = B != MIN_TICK ? Duration( B - Reported ) : Now - R.Began;
+                    R.Ongoing = false;
+                    Open = false;
+                }
+                else
+                    R.Length = Now - R.Began;
+            }
+
+            if (!Open && B != MIN_TICK && B != Reported && Now - Duration( B ) > Threshold)
+            {
+                _Capture( B, Now );
+                Reported = B;
+                Open = true;
+            }
+        }
+
+        std::lock_guard<std::mutex> Lock( Guard );
+        if (Open && Stalls)  // stopped during a stall
+        {
+            StallReport& R = Reports[(Stalls - 1) % Reports.size()];
+            R.Length = ProgramTime() - R.Began;
+        }
+    }
+
+    uint64_t FrameWatchdog::GetStallCount() const
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        return Stalls;
+    }
+
+    size_t FrameWatchdog::GetReports( StallReport* Out, size_t Max ) const
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        uint64_t Kept = Stalls < Reports.size() ? Stalls : Reports.size();
+        if (Kept > Max)
+            Kept = Max;
+        for (uint64_t i = Stalls - Kept; i < Stalls; i++)
+            *Out++ = Reports[i % Reports.size()];
+        return size_t( Kept );
+    }
+
+    size_t FrameWatchdog::WriteReports( std::ostream& Out ) const
+    {
+        std::vector<StallReport> Copy( Reports.size() );
+        Copy.resize( GetReports( Copy.data(), Copy.size() ) );
+        char Stamp[ISO8601_BUFFER_SIZE];
+        for (const StallReport& R : Copy)
+        {
+            FormatISO8601( R.Moment, Stamp, sizeof( Stamp ) );
+            Out << Stamp << " stall " << R.Length.asMilliSec() << " ms thread " << R.Thread << (R.Ongoing ? " (ongoing)" : "") << ":";
+            size_t N = R.Depth < PROFILE_STACK_DEPTH ? R.Depth : PROFILE_STACK_DEPTH;
+            for (size_t i = 0; i < N; i++)
+                Out << (i ? " > " : " ") << R.Zones[i];
+            if (R.Depth > N)
+                Out << " > ...";
+            Out << "\n";
+        }
+        return Copy.size();
+    }
+
+    void FrameWatchdog::ClearReports()
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        Stalls = 0;
+    }
+
+}
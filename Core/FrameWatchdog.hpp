@@ -0,0 +1,107 @@
+/*
+* Perspective module for frame stall detection.
+* The main loop publishes a heartbeat every frame (one clock reading and one
+* relaxed store); a watchdog thread checks it a few times per threshold and,
+* when a frame runs longer than the threshold, captures a timestamped report
+* while the stall is still going on: open PROFILE_SCOPE zones of the stalled
+* thread, its id and the stall length (final once the next heartbeat comes).
+* Reports go into a ring preallocated at construction, nothing is allocated
+* after Start().
+* Depends on Perspective::Timer.hpp, Perspective::TimeUtils.hpp,
+* Perspective::Profiler.hpp, Perspective::TimeFormat.hpp, <thread>, <mutex>
+*/
+
+#pragma once
+
+// Standart dependencies: <atomic>, <thread>, <mutex>, <vector>, <iosfwd>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <iosfwd>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+#include "TimeUtils.hpp"
+#include "Profiler.hpp"
+
+namespace Perspective
+{
+// ============================= StallReport ================================
+
+    // single stall of the watched thread
+    struct StallReport
+    {
+        Time Moment;  // wall time the stall was detected
+        Duration Began;  // moment of the last heartbeat before the stall (since program start)
+        Duration Length;  // stall length: so far while Ongoing, final afterwards
+        std::thread::id Thread;  // stalled thread
+        uint32_t ProfileTid;  // its id in profiler traces, 0 if the profiler was disabled on Start()
+        uint32_t Depth;  // amount of open zones at detection (may exceed PROFILE_STACK_DEPTH)
+        const char* Zones[PROFILE_STACK_DEPTH];  // names of open zones, the outermost first
+        bool Ongoing;  // the thread hasn't sent a heartbeat since
+    };
+
+    typedef void ( *StallHandler )( const StallReport& Report, void* User );
+
+// ============================ FrameWatchdog ===============================
+
+    // Class FrameWatchdog - watches heartbeats of a single thread. Heartbeat()
+    // is lock-free and may be called from the watched thread only; other
+    // methods are thread-safe.
+    class FrameWatchdog
+    {
+    protected:
+        std::atomic<time_tick_t> Beat{ MIN_TICK };  // ticks of the last heartbeat, MIN_TICK - disarmed
+        Duration Threshold;  // frames longer than this are reported
+        Duration Period;  // interval of checks
+        std::thread::id Watched;  // thread which called Start()
+        uint32_t WatchedTid = 0;  // its profiler id
+        StallHandler Handler = nullptr;  // called from the watchdog thread on detection
+        void* HandlerData = nullptr;
+
+        mutable std::mutex Guard;  // guards reports, never taken by Heartbeat()
+        std::vector<StallReport> Reports;  // ring of the latest reports
+        uint64_t Stalls = 0;  // total amount of reports
+
+        TimedEvent Wake;  // wakes the watchdog thread to stop
+        std::atomic<bool> Running{ false };
+        std::thread Worker;
+
+        void _Watch();  // watchdog thread body
+        void _Capture( time_tick_t Beat, const Duration& Now );
+    public:
+        explicit FrameWatchdog( const Duration& StallThreshold = millisec( 100 ), size_t Capacity = 64 );
+        ~FrameWatchdog() { Stop(); }
+
+        FrameWatchdog( const FrameWatchdog& ) = delete;
+        FrameWatchdog& operator= ( const FrameWatchdog& ) = delete;
+
+        // launches the watchdog thread. Watches the calling thread, which
+        // sends heartbeats from now on (first one is sent here)
+        void Start();
+        void Stop();  // joins the watchdog thread
+        inline bool IsRunning() const { return Running.load( std::memory_order_relaxed ); }
+
+        // marks start of a frame. Costs a clock reading and a relaxed store
+        inline void Heartbeat() { Beat.store( ProgramTime().getTicks(), std::memory_order_relaxed ); }
+        inline void Heartbeat( const Duration& Now ) { Beat.store( Now.getTicks(), std::memory_order_relaxed ); }  // with a frame time already read
+        // stops reporting till the next heartbeat (loading screens, breakpoints)
+        inline void Disarm() { Beat.store( MIN_TICK, std::memory_order_relaxed ); }
+
+        // set up before Start()
+        void SetThreshold( const Duration& StallThreshold );
+        inline Duration GetThreshold() const { return Threshold; }
+        // Handler is called by the watchdog thread right after a stall is
+        // detected, while the watched thread is still stalled
+        void SetHandler( StallHandler H, void* User = nullptr );
+
+        uint64_t GetStallCount() const;  // total amount of stalls, including overwritten reports
+        // copies up to Max latest reports, the oldest first. Returns amount of copied
+        size_t GetReports( StallReport* Out, size_t Max ) const;
+        // writes latest reports one per line:
+        // "2026-10-17T12:00:00.123 stall 312.4 ms thread 1403 (ongoing): Frame > Update > LoadMesh"
+        size_t WriteReports( std::ostream& Out ) const;
+        void ClearReports();
+    };
+}
@@ -0,0 +1,345 @@
+/* JobSystem Realizations
+ * Depends on Perspective::TimeUtils.hpp, <thread>
+ */
+
+#include "JobSystem.hpp"
+#include "TimeUtils.hpp"  // _AddressWait, _AddressWake
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>  // _mm_pause
+#endif
+
+// ----------------------- Local utility functions --------------------------
+
+namespace
+{
+    // polite busy-wait iteration
+    inline void _SpinPause()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#endif
+    }
+
+    const unsigned IDLE_SPINS = 256;  // empty fetches of a worker before it parks
+
+    // worker identity of current thread, constant-initialized
+    thread_local const Perspective::JobSystem* _LocalSystem = nullptr;
+    thread_local int _LocalIndex = -1;
+    thread_local Perspective::JobSystem::Job* _LocalJob = nullptr;  // job being executed
+}
+
+// --------------------------------------------------------------------------
+
+namespace Perspective
+{
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ JobSystem ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    JobSystem::JobSystem( unsigned WorkerCount )
+    {
+        Workers = WorkerCount ? WorkerCount : std::thread::hardware_concurrency();
+        if (!Workers)
+            Workers = 1;
+        for (unsigned i = 0; i < Workers; i++)
+        {
+            Queues.emplace_back( new _WorkDeque<Job, JOBS_PER_THREAD> );
+            Rings.emplace_back( new _JobRing );
+        }
+        Rings.emplace_back( new _JobRing );  // shared by other threads
+
+        _LocalSystem = this;  // the owner is worker 0
+        _LocalIndex = 0;
+        for (unsigned i = 1; i < Workers; i++)
+            Threads.emplace_back( &JobSystem::_WorkerLoop, this, i );
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Running.store( false );
+        Epoch.fetch_add( 1 );
+        _AddressWake( Epoch, true );
+        for (std::thread& T : Threads)
+            T.join();
+        if (_LocalSystem == this)
+        {
+            _LocalSystem = nullptr;
+            _LocalIndex = -1;
+        }
+    }
+
+    int JobSystem::_Index() const
+    {
+        return _LocalSystem == this ? _LocalIndex : -1;
+    }
+
+    JobSystem::JobHandle JobSystem::CurrentJob()
+    {
+        return _LocalJob ? _Handle( _LocalJob ) : JobHandle();
+    }
+
+    JobSystem::Job* JobSystem::_TryAllocate( Job* Parent )
+    {
+        int I = _Index();
+        _JobRing& R = *Rings[I >= 0 ? unsigned( I ) : Workers];
+        Job* J = nullptr;
+        for (size_t Tries = 0; Tries < JOBS_PER_THREAD && !J; Tries++)
+        {
+            // the oldest slots are the most likely finished. Claimed by CAS:
+            // the ring of other threads is shared
+            Job* Slot = &R.Jobs[R.Next.fetch_add( 1, std::memory_order_relaxed ) & (JOBS_PER_THREAD - 1)];
+            uint32_t Free = 0;
+            if (Slot->Unfinished.compare_exchange_strong( Free, _CLAIMING, std::memory_order_acquire, std::memory_order_relaxed ))
+                J = Slot;
+        }
+        if (!J)
+            return nullptr;
+        // new generation first: whoever sees the job unfinished sees it too
+        J->Generation.store( uint16_t( J->Generation.load( std::memory_order_relaxed ) + 1 ), std::memory_order_relaxed );
+        J->Unfinished.store( 1, std::memory_order_release );
+        J->Parent = Parent;
+        J->ContinuationCount.store( 0, std::memory_order_relaxed );
+        J->Range = nullptr;
+        if (Parent)
+            Parent->Unfinished.fetch_add( 1, std::memory_order_relaxed );
+        return J;
+    }
+
+    JobSystem::Job* JobSystem::_Allocate( Job* Parent )
+    {
+        int I = _Index();
+        unsigned Idle = 0;
+        for (;;)
+        {
+            if (Job* J = _TryAllocate( Parent ))
+                return J;
+            if (Job* W = _Fetch( I ))  // finishing others frees slots
+            {
+                _Execute( W );
+                Idle = 0;
+            }
+            else if (++Idle < IDLE_SPINS)
+                _SpinPause();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    JobSystem::JobHandle JobSystem::Create( JobFunction F, JobHandle Parent )
+    {
+        Job* J = _Allocate( Parent.Slot );
+        J->Function = std::move( F );
+        return _Handle( J );
+    }
+
+    JobSystem::JobHandle JobSystem::CreateContinuation( JobHandle Antecedent, JobFunction F )
+    {
+        uint16_t N = Antecedent.Slot->ContinuationCount.load( std::memory_order_relaxed );
+        if (N >= JOB_CONTINUATIONS)
+            return nullptr;
+        JobHandle J = Create( std::move( F ) );
+        Antecedent.Slot->Continuations[N] = J.Slot;
+        Antecedent.Slot->ContinuationCount.store( uint16_t( N + 1 ), std::memory_order_release );
+        return J;
+    }
+
+    JobSystem::Job* JobSystem::_InitRange( Job* J, const RangeFunction* Body, size_t Begin, size_t End, size_t Grain )
+    {
+        J->Function = nullptr;
+        J->Range = Body;
+        J->Begin = Begin;
+        J->End = End;
+        J->Grain = Grain;
+        return J;
+    }
+
+    void JobSystem::Run( JobHandle J )
+    {
+        _Schedule( J.Slot );
+    }
+
+    void JobSystem::_Schedule( Job* J )
+    {
+        int I = _Index();
+        if (I >= 0)
+        {
+            if (!Queues[I]->Push( J ))  // deque is full: no point to queue more
+            {
+                _Execute( J );
+                return;
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> Lock( InjectGuard );
+            Injected.push_back( J );
+            InjectedCount.fetch_add( 1, std::memory_order_relaxed );
+        }
+        _WakeOne();
+    }
+
+    void JobSystem::_WakeOne()
+    {
+        // pairs with the fence of a parking worker: either it sees the new
+        // job or we see it among sleepers
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if (Sleepers.load( std::memory_order_relaxed ))
+        {
+            Epoch.fetch_add( 1, std::memory_order_release );
+            _AddressWake( Epoch, false );
+        }
+    }
+
+    bool JobSystem::_HasWork() const
+    {
+        if (InjectedCount.load( std::memory_order_relaxed ))
+            return true;
+        for (const std::unique_ptr<_WorkDeque<Job, JOBS_PER_THREAD>>& Q : Queues)
+            if (!Q->IsEmpty())
+                return true;
+        return false;
+    }
+
+    JobSystem::Job* JobSystem::_Fetch( int Index )
+    {
+        if (Index >= 0)
+            if (Job* J = Queues[Index]->Pop())
+                return J;
+
+        if (InjectedCount.load( std::memory_order_relaxed ))
+        {
+            std::lock_guard<std::mutex> Lock( InjectGuard );
+            if (!Injected.empty())
+            {
+                Job* J = Injected.front();
+                Injected.pop_front();
+                InjectedCount.fetch_sub( 1, std::memory_order_relaxed );
+                return J;
+            }
+        }
+
+        // steal starting from the next worker, so thieves spread over victims
+        unsigned First = Index >= 0 ? unsigned( Index ) + 1 : 0;
+        for (unsigned k = 0; k < Workers; k++)
+        {
+            unsigned Victim = (First + k) % Workers;
+            if (int( Victim ) != Index)
+                if (Job* J = Queues[Victim]->Steal())
+                    return J;
+        }
+        return nullptr;
+    }
+
+    void JobSystem::_Execute( Job* J )
+    {
+        Job* Outer = _LocalJob;
+        _LocalJob = J;
+        if (J->Range)
+            _Split( J, J->Range, J->Begin, J->End, J->Grain );
+        else
+            J->Function();
+        _LocalJob = Outer;
+        _Finish( J );
+    }
+
+    void JobSystem::_Finish( Job* J )
+    {
+        while (J)
+        {
+            // read links first: the slot may be reused once the job is done
+            Job* Parent = J->Parent;
+            Job* Continuations[JOB_CONTINUATIONS];
+            uint32_t N = J->ContinuationCount.load( std::memory_order_acquire );
+            for (uint32_t i = 0; i < N; i++)
+                Continuations[i] = J->Continuations[i];
+            if (J->Unfinished.fetch_sub( 1, std::memory_order_acq_rel ) != 1)
+                return;
+            for (uint32_t i = 0; i < N; i++)
+                _Schedule( Continuations[i] );
+            J = Parent;
+        }
+    }
+
+    void JobSystem::_Split( Job* Parent, const RangeFunction* Body, size_t Begin, size_t End, size_t Grain )
+    {
+        // hand the upper halves out, keep the lowest part
+        while (End - Begin > Grain)
+        {
+            Job* Half = _TryAllocate( Parent );
+            if (!Half)  // ring is full of unfinished jobs: the rest runs here
+                break;
+            size_t Middle = Begin + (End - Begin) / 2;
+            _Schedule( _InitRange( Half, Body, Middle, End, Grain ) );
+            End = Middle;
+        }
+        if (Begin < End)
+            (*Body)( Begin, End );
+    }
+
+    void JobSystem::Wait( JobHandle J )
+    {
+        int I = _Index();
+        unsigned Idle = 0;
+        while (!IsDone( J ))
+        {
+            if (Job* W = _Fetch( I ))
+            {
+                _Execute( W );
+                Idle = 0;
+            }
+            else if (++Idle < IDLE_SPINS)
+                _SpinPause();
+            else
+                std::this_thread::yield();  // the rest runs on other workers
+        }
+    }
+
+    JobSystem::JobHandle JobSystem::CreateParallelFor( size_t Count, size_t Grain, RangeFunction Body, JobHandle Parent )
+    {
+        if (!Grain)
+            Grain = Count / (Workers * 4) ? Count / (Workers * 4) : 1;
+        return Create( [this, Count, Grain, Body]() { _Split( _LocalJob, &Body, 0, Count, Grain ); }, Parent );
+    }
+
+    void JobSystem::ParallelFor( size_t Count, size_t Grain, const RangeFunction& Body )
+    {
+        if (!Grain)
+            Grain = Count / (Workers * 4) ? Count / (Workers * 4) : 1;
+        Job* Root = _InitRange( _Allocate( nullptr ), &Body, 0, Count, Grain );
+        JobHandle Handle = _Handle( Root );
+        _Execute( Root );  // splits right away instead of waiting for a thief
+        Wait( Handle );
+    }
+
+    void JobSystem::_WorkerLoop( unsigned Index )
+    {
+        _LocalSystem = this;
+        _LocalIndex = int( Index );
+        unsigned Idle = 0;
+        while (Running.load( std::memory_order_relaxed ))
+        {
+            if (Job* J = _Fetch( int( Index ) ))
+            {
+                _Execute( J );
+                Idle = 0;
+                continue;
+            }
+            if (++Idle < IDLE_SPINS)
+            {
+                _SpinPause();
+                continue;
+            }
+
+            // park: announce, then recheck, so a job run meanwhile either is
+            // seen here or wakes us
+            uint32_t E = Epoch.load( std::memory_order_acquire );
+            Sleepers.fetch_add( 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            if (!_HasWork() && Running.load( std::memory_order_relaxed ))
+                _AddressWait( Epoch, E, MAX_Duration );
+            Sleepers.fetch_sub( 1, std::memory_order_relaxed );
+            Idle = 0;
+        }
+    }
+
+}
@@ -0,0 +1,232 @@
+/*
+* Perspective module for work-stealing parallel jobs.
+* One worker per core: the thread that creates JobSystem is worker 0 and
+* helps while it waits, hardware_concurrency() - 1 threads are started.
+* Every worker owns a Chase-Lev deque: the owner pushes and pops at the
+* bottom without locks, idle workers steal from the top. Workers with
+* nothing to steal park on a futex (TimeUtils address wait) and cost no
+* CPU until new jobs are run.
+* Jobs are taken from per-thread rings, so creating a job allocates nothing
+* (except captures too large for std::function's small buffer). A thread
+* with all its ring slots unfinished executes other jobs until one is free.
+* Depends on Perspective::TimeUtils.hpp, <functional>, <thread>, <vector>
+*/
+
+#pragma once
+
+// Standart dependencies: <atomic>, <cstddef>, <functional>, <thread>, <mutex>, <deque>, <vector>, <memory>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace Perspective
+{
+    // amount of unfinished jobs created by a single thread. Slots of finished
+    // jobs are reused by newer jobs of the same thread: a handle keeps the
+    // generation of its slot, so it still reports its own job as done
+    constexpr size_t JOBS_PER_THREAD = 4096;
+    constexpr size_t JOB_CONTINUATIONS = 6;  // continuations of a single job
+
+// ============================= Work deque =================================
+
+    // Chase-Lev work-stealing deque of fixed capacity (Le, Pop, Cohen, Nardelli
+    // 2013 memory orders). Push and Pop by the owner only, Steal by any thread
+    template<class T, size_t Capacity>
+    class _WorkDeque
+    {
+    protected:
+        static_assert( (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two" );
+
+        alignas( 64 ) std::atomic<int64_t> Top{ 0 };  // next to steal
+        alignas( 64 ) std::atomic<int64_t> Bottom{ 0 };  // next to push
+        std::atomic<T*> Items[Capacity];
+    public:
+        // returns false if the deque is full
+        bool Push( T* Item )
+        {
+            int64_t B = Bottom.load( std::memory_order_relaxed );
+            int64_t Tp = Top.load( std::memory_order_acquire );
+            if (B - Tp >= int64_t( Capacity ))
+                return false;
+            Items[B & (Capacity - 1)].store( Item, std::memory_order_relaxed );
+            Bottom.store( B + 1, std::memory_order_release );  // publishes the item to thieves
+            return true;
+        }
+
+        // takes the newest item. Returns nullptr if empty
+        T* Pop()
+        {
+            int64_t B = Bottom.load( std::memory_order_relaxed ) - 1;
+            Bottom.store( B, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            int64_t Tp = Top.load( std::memory_order_relaxed );
+            if (Tp > B)  // empty
+            {
+                Bottom.store( B + 1, std::memory_order_relaxed );
+                return nullptr;
+            }
+            T* Item = Items[B & (Capacity - 1)].load( std::memory_order_relaxed );
+            if (Tp == B)  // the last item: race with thieves
+            {
+                if (!Top.compare_exchange_strong( Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed ))
+                    Item = nullptr;
+                Bottom.store( B + 1, std::memory_order_relaxed );
+            }
+            return Item;
+        }
+
+        // takes the oldest item. Returns nullptr if empty or lost a race
+        T* Steal()
+        {
+            int64_t Tp = Top.load( std::memory_order_acquire );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            int64_t B = Bottom.load( std::memory_order_acquire );
+            if (Tp >= B)
+                return nullptr;
+            T* Item = Items[Tp & (Capacity - 1)].load( std::memory_order_relaxed );
+            if (!Top.compare_exchange_strong( Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed ))
+                return nullptr;
+            return Item;
+        }
+
+        inline bool IsEmpty() const { return Top.load( std::memory_order_relaxed ) >= Bottom.load( std::memory_order_relaxed ); }
+    };
+
+// ============================== JobSystem =================================
+
+    // Class JobSystem - pool of workers executing jobs. A job finishes when
+    // its function and all its children are finished; then its continuations
+    // are run and its parent is notified. Create, Run and Wait may be called
+    // from any thread, including from inside jobs. Threads other than the
+    // workers share a locked queue, so heavy producers should be jobs.
+    class JobSystem
+    {
+    public:
+        typedef std::function<void()> JobFunction;
+        typedef std::function<void( size_t Begin, size_t End )> RangeFunction;
+
+        // two cache lines
+        struct alignas( 64 ) Job
+        {
+            JobFunction Function;  // empty for range jobs
+            Job* Parent;  // notified when the job finishes
+            std::atomic<uint32_t> Unfinished;  // the job itself and its unfinished children, _CLAIMING while reused
+            std::atomic<uint16_t> Generation;  // incremented on every reuse of the slot
+            std::atomic<uint16_t> ContinuationCount;
+            Job* Continuations[JOB_CONTINUATIONS];  // run when the job finishes
+            const RangeFunction* Range;  // range job of ParallelFor: splits [Begin, End) by Grain
+            size_t Begin, End, Grain;
+        };
+
+        // job slot and its generation when the job was created: tells the job
+        // apart from newer ones reusing the slot. The generation wraps after
+        // 65536 reuses of a slot, far beyond the lifetime of a frame's handles
+        struct JobHandle
+        {
+            Job* Slot = nullptr;
+            uint16_t Generation = 0;
+
+            JobHandle() = default;
+            JobHandle( std::nullptr_t ) {}
+            JobHandle( Job* S, uint16_t G ) : Slot( S ), Generation( G ) {}
+
+            explicit operator bool() const { return Slot != nullptr; }
+            bool operator== ( const JobHandle& H ) const { return Slot == H.Slot && Generation == H.Generation; }
+            bool operator!= ( const JobHandle& H ) const { return !(*this == H); }
+        };
+
+    protected:
+        static constexpr uint32_t _CLAIMING = ~uint32_t( 0 );  // Unfinished of a slot being reused
+
+        static inline JobHandle _Handle( Job* J ) { return JobHandle( J, J->Generation.load( std::memory_order_relaxed ) ); }
+
+        // jobs created by a single thread
+        struct alignas( 64 ) _JobRing
+        {
+            std::unique_ptr<Job[]> Jobs{ new Job[JOBS_PER_THREAD] };
+            std::atomic<uint64_t> Next{ 0 };  // next slot to try
+
+            _JobRing()
+            {
+                for (size_t i = 0; i < JOBS_PER_THREAD; i++)
+                {
+                    Jobs[i].Unfinished.store( 0, std::memory_order_relaxed );  // free
+                    Jobs[i].Generation.store( 0, std::memory_order_relaxed );
+                }
+            }
+        };
+
+        unsigned Workers;  // including the owner thread
+        std::vector<std::unique_ptr<_WorkDeque<Job, JOBS_PER_THREAD>>> Queues;  // one per worker
+        std::vector<std::unique_ptr<_JobRing>> Rings;  // one per worker plus one shared by other threads
+        std::vector<std::thread> Threads;  // workers 1..Workers-1
+
+        std::mutex InjectGuard;
+        std::deque<Job*> Injected;  // jobs run by threads other than the workers
+        std::atomic<uint32_t> InjectedCount{ 0 };
+
+        alignas( 64 ) std::atomic<uint32_t> Epoch{ 0 };  // parked workers wait for it to change
+        std::atomic<uint32_t> Sleepers{ 0 };  // amount of parked (or parking) workers
+        std::atomic<bool> Running{ true };
+
+        int _Index() const;  // worker index of current thread, -1 for other threads
+        Job* _TryAllocate( Job* Parent );  // claims a slot of a finished job. nullptr if the ring is full
+        Job* _Allocate( Job* Parent );  // claims a slot, executing other jobs while the ring is full
+        Job* _InitRange( Job* J, const RangeFunction* Body, size_t Begin, size_t End, size_t Grain );
+        bool _HasWork() const;
+        Job* _Fetch( int Index );  // own queue, injected jobs, then steals
+        void _Execute( Job* J );
+        void _Finish( Job* J );
+        void _Schedule( Job* J );
+        void _WakeOne();
+        void _WorkerLoop( unsigned Index );
+        void _Split( Job* Parent, const RangeFunction* Body, size_t Begin, size_t End, size_t Grain );
+    public:
+        // WorkerCount - total amount of workers including the calling
+        // thread, 0 - one per hardware thread
+        explicit JobSystem( unsigned WorkerCount = 0 );
+        ~JobSystem();  // waits for running jobs of the workers, drops queued ones
+
+        JobSystem( const JobSystem& ) = delete;
+        JobSystem& operator= ( const JobSystem& ) = delete;
+
+        inline unsigned GetWorkerCount() const { return Workers; }
+
+        // creates a job without running it. If Parent is given, the parent
+        // doesn't finish until this job does: create children before the
+        // parent finishes (e.g. from inside the parent). A job created but
+        // never run keeps its ring slot forever
+        JobHandle Create( JobFunction F, JobHandle Parent = nullptr );
+        // creates a job run once Antecedent finishes. Must be called before
+        // Antecedent is run. Returns nullptr if it has JOB_CONTINUATIONS already
+        JobHandle CreateContinuation( JobHandle Antecedent, JobFunction F );
+        void Run( JobHandle J );  // schedules the job
+        inline JobHandle Spawn( JobFunction F, JobHandle Parent = nullptr ) { JobHandle J = Create( std::move( F ), Parent ); Run( J ); return J; }
+
+        // executes other jobs until J finishes
+        void Wait( JobHandle J );
+        // a slot seen claimed by a newer job means J is long done: the
+        // generation is published before the claim completes
+        static inline bool IsDone( JobHandle J )
+        {
+            uint32_t U = J.Slot->Unfinished.load( std::memory_order_acquire );
+            return U == 0 || U == _CLAIMING || J.Slot->Generation.load( std::memory_order_relaxed ) != J.Generation;
+        }
+
+        // job calling Body( Begin, End ) on subranges of [0, Count) no longer
+        // than Grain (0 - picked for 4 chunks per worker), split recursively
+        // so idle workers steal the halves. Not run yet. Body is kept in the
+        // job, subrange jobs allocate nothing. While the ring of a splitting
+        // thread is full, the rest of its subrange runs inline
+        JobHandle CreateParallelFor( size_t Count, size_t Grain, RangeFunction Body, JobHandle Parent = nullptr );
+        // runs Body over [0, Count) on all workers and waits. Allocates nothing
+        void ParallelFor( size_t Count, size_t Grain, const RangeFunction& Body );
+
+        static JobHandle CurrentJob();  // job executed by current thread, nullptr outside of jobs
+    };
+}
@@ -0,0 +1,273 @@
+/* Profiler Realizations
+ * Depends on Perspective::Timer.hpp, <vector>, <memory>, <mutex>, <fstream>
+ */
+
+#include "Profiler.hpp"
+
+// Standart dependencies: <vector>, <memory>, <mutex>, <ostream>, <fstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <fstream>
+
+// ----------------------- Local utility functions --------------------------
+
+namespace
+{
+    // single complete zone
+    struct _ProfileZone
+    {
+        const char* Name;
+        Perspective::time_tick_t Begin;  // ProgramTime() ticks
+        Perspective::time_tick_t End;
+    };
+
+    // slot of the ring buffer. Relaxed atomics: the dump copies slots while
+    // the owner may overwrite them and validates the copy by Head afterwards
+    struct _ProfileEvent
+    {
+        std::atomic<const char*> Name;
+        std::atomic<Perspective::time_tick_t> Begin;
+        std::atomic<Perspective::time_tick_t> End;
+    };
+
+    // single-producer ring buffer of one thread
+    struct _ProfileBuffer
+    {
+        std::unique_ptr<_ProfileEvent[]> Events{ new _ProfileEvent[Perspective::PROFILE_EVENTS_PER_THREAD] };
+        std::atomic<uint64_t> Head{ 0 };  // amount of recorded events, written by the owner only
+        uint64_t ClearedAt = 0;  // Head at the last ClearProfile: older events are dropped. Under registry lock
+        std::atomic<bool> Finished{ false };  // the owner thread has exited
+        bool Dumped = false;  // finished and its events dumped or cleared: free for a new thread. Under registry lock
+        std::atomic<const char*> ThreadName{ nullptr };  // set by the owner at any time
+        uint32_t Tid = 0;  // sequential thread id for the trace
+        std::atomic<const char*> Stack[Perspective::PROFILE_STACK_DEPTH] = {};  // names of open zones
+        std::atomic<uint32_t> Depth{ 0 };  // amount of open zones, written by the owner only
+    };
+
+    // all buffers ever created. Buffers of finished threads are kept till
+    // the next dump or clear, then given to new threads
+    struct _ProfileRegistry
+    {
+        std::mutex Guard;  // taken on thread registration and dump only
+        std::vector<std::unique_ptr<_ProfileBuffer>> Buffers;
+    };
+
+    _ProfileRegistry& _Registry()
+    {
+        static _ProfileRegistry Registry;
+        return Registry;
+    }
+
+    thread_local _ProfileBuffer* _LocalBuffer = nullptr;  // constant-initialized, no TLS guard
+
+    // marks the buffer of an exiting thread finished. Touched only on
+    // registration, so zones don't pay for the TLS guard
+    struct _ProfileThreadExit
+    {
+        _ProfileBuffer* Buffer = nullptr;
+        ~_ProfileThreadExit()
+        {
+            if (Buffer)
+                Buffer->Finished.store( true, std::memory_order_release );
+            _LocalBuffer = nullptr;
+        }
+    };
+    thread_local _ProfileThreadExit _ExitGuard;
+
+    _ProfileBuffer* _RegisterThread()
+    {
+        _ProfileRegistry& R = _Registry();
+        _ProfileBuffer* B = nullptr;
+        {
+            std::lock_guard<std::mutex> Lock( R.Guard );
+            for (const std::unique_ptr<_ProfileBuffer>& Old : R.Buffers)
+                if (Old->Dumped)  // reuse: its owner is gone and its events are out
+                {
+                    B = Old.get();
+                    B->Head.store( 0, std::memory_order_relaxed );
+                    B->ClearedAt = 0;
+                    B->Depth.store( 0, std::memory_order_relaxed );
+                    B->ThreadName.store( nullptr, std::memory_order_relaxed );
+                    B->Finished.store( false, std::memory_order_relaxed );
+                    B->Dumped = false;
+                    break;
+                }
+            if (!B)
+            {
+                R.Buffers.emplace_back( new _ProfileBuffer );
+                B = R.Buffers.back().get();
+                B->Tid = uint32_t( R.Buffers.size() );
+            }
+        }
+        _ExitGuard.Buffer = B;
+        return _LocalBuffer = B;
+    }
+
+    // JSON string body
+    void _WriteEscaped( std::ostream& Out, const char* S )
+    {
+        for (; *S; ++S)
+        {
+            if (*S == '"' || *S == '\\')
+                Out << '\\' << *S;
+            else if ((unsigned char)*S < 0x20)
+                Out << ' ';
+            else
+                Out << *S;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------
+
+namespace Perspective
+{
+
+    std::atomic<bool> _ProfilerEnabled{ true };
+
+    void SetProfilerEnabled( bool Enabled ) { _ProfilerEnabled.store( Enabled, std::memory_order_relaxed ); }
+
+    bool IsProfilerEnabled() { return _ProfilerEnabled.load( std::memory_order_relaxed ); }
+
+    void ProfileThreadInit( const char* Name )
+    {
+        _ProfileBuffer* B = _LocalBuffer ? _LocalBuffer : _RegisterThread();
+        if (Name)
+            B->ThreadName.store( Name, std::memory_order_relaxed );
+    }
+
+    void _ProfileEnter( const char* Name )
+    {
+        _ProfileBuffer* B = _LocalBuffer ? _LocalBuffer : _RegisterThread();
+        uint32_t D = B->Depth.load( std::memory_order_relaxed );
+        if (D < PROFILE_STACK_DEPTH)
+            B->Stack[D].store( Name, std::memory_order_relaxed );
+        B->Depth.store( D + 1, std::memory_order_relaxed );  // no ordering: readers accept a stale innermost entry
+    }
+
+    void _ProfileLeave( const char* Name, const Duration& Begin, const Duration& End )
+    {
+        _ProfileBuffer* B = _LocalBuffer;  // registered by _ProfileEnter
+        B->Depth.store( B->Depth.load( std::memory_order_relaxed ) - 1, std::memory_order_relaxed );
+        _ProfileRecord( Name, Begin, End );
+    }
+
+    void _ProfileRecord( const char* Name, const Duration& Begin, const Duration& End )
+    {
+        _ProfileBuffer* B = _LocalBuffer ? _LocalBuffer : _RegisterThread();
+        uint64_t H = B->Head.load( std::memory_order_relaxed );
+        _ProfileEvent& E = B->Events[H & (PROFILE_EVENTS_PER_THREAD - 1)];
+        E.Name.store( Name, std::memory_order_relaxed );
+        E.Begin.store( Begin.getTicks(), std::memory_order_relaxed );
+        E.End.store( End.getTicks(), std::memory_order_relaxed );
+        B->Head.store( H + 1, std::memory_order_release );
+    }
+
+    size_t WriteChromeTrace( std::ostream& Out )
+    {
+        _ProfileRegistry& R = _Registry();
+        std::lock_guard<std::mutex> Lock( R.Guard );
+
+        std::vector<_ProfileZone> Copy;
+        size_t Written = 0;
+        std::streamsize Precision = Out.precision( 15 );  // microseconds with fraction of program lifetime
+        bool First = true;
+        Out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        for (const std::unique_ptr<_ProfileBuffer>& B : R.Buffers)
+        {
+            if (B->Dumped)  // free, waits for a new thread
+                continue;
+            bool Finished = B->Finished.load( std::memory_order_acquire );  // no more events after this dump
+
+            if (const char* ThreadName = B->ThreadName.load( std::memory_order_relaxed ))
+            {
+                Out << (First ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << B->Tid << ",\"args\":{\"name\":\"";
+                _WriteEscaped( Out, ThreadName );
+                Out << "\"}}";
+                First = false;
+            }
+
+            // copy, then keep only events the owner could not overwrite meanwhile
+            uint64_t Head = B->Head.load( std::memory_order_acquire );
+            uint64_t From = Head > PROFILE_EVENTS_PER_THREAD ? Head - PROFILE_EVENTS_PER_THREAD : 0;
+            if (From < B->ClearedAt)
+                From = B->ClearedAt;
+            Copy.resize( size_t( Head - From ) );
+            for (uint64_t i = From; i < Head; i++)
+            {
+                const _ProfileEvent& E = B->Events[i & (PROFILE_EVENTS_PER_THREAD - 1)];
+                Copy[size_t( i - From )] = _ProfileZone{ E.Name.load( std::memory_order_relaxed ),
+                    E.Begin.load( std::memory_order_relaxed ), E.End.load( std::memory_order_relaxed ) };
+            }
+            // the copy is read before Head again. The owner writing event
+            // After may be overwriting event After - PROFILE_EVENTS_PER_THREAD
+            // already, so that one is dropped too
+            std::atomic_thread_fence( std::memory_order_acquire );
+            uint64_t After = B->Head.load( std::memory_order_relaxed );
+            uint64_t Valid = After + 1 > PROFILE_EVENTS_PER_THREAD ? After + 1 - PROFILE_EVENTS_PER_THREAD : 0;
+
+            for (uint64_t i = Valid > From ? Valid : From; i < Head; i++)
+            {
+                const _ProfileZone& E = Copy[size_t( i - From )];
+                Out << (First ? "" : ",") << "\n{\"name\":\"";
+                _WriteEscaped( Out, E.Name );
+                Out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << B->Tid
+                    << ",\"ts\":" << Duration( E.Begin ).asMicroSec()
+                    << ",\"dur\":" << Duration( E.End - E.Begin ).asMicroSec() << "}";
+                First = false;
+                Written++;
+            }
+            B->Dumped = Finished;
+        }
+        Out << "\n]}\n";
+        Out.precision( Precision );
+        return Written;
+    }
+
+    bool WriteChromeTrace( const char* Path )
+    {
+        std::ofstream File( Path );
+        if (!File)
+            return false;
+        WriteChromeTrace( File );
+        return bool( File );
+    }
+
+    void ClearProfile()
+    {
+        _ProfileRegistry& R = _Registry();
+        std::lock_guard<std::mutex> Lock( R.Guard );
+        for (const std::unique_ptr<_ProfileBuffer>& B : R.Buffers)
+        {
+            // owners keep writing: only the dump skips what is recorded so far
+            bool Finished = B->Finished.load( std::memory_order_acquire );
+            B->ClearedAt = B->Head.load( std::memory_order_acquire );
+            B->Dumped = B->Dumped || Finished;
+        }
+    }
+
+    uint32_t ProfileThreadId()
+    {
+        return (_LocalBuffer ? _LocalBuffer : _RegisterThread())->Tid;
+    }
+
+    size_t ReadProfileStack( uint32_t Tid, const char** Out, size_t Max )
+    {
+        _ProfileBuffer* B;
+        {
+            _ProfileRegistry& R = _Registry();
+            std::lock_guard<std::mutex> Lock( R.Guard );
+            if (Tid == 0 || Tid > R.Buffers.size())
+                return 0;
+            B = R.Buffers[Tid - 1].get();  // buffers are never freed
+        }
+        uint32_t D = B->Depth.load( std::memory_order_acquire );
+        size_t N = D < PROFILE_STACK_DEPTH ? D : PROFILE_STACK_DEPTH;
+        for (size_t i = 0; i < N && i < Max; i++)
+            Out[i] = B->Stack[i].load( std::memory_order_relaxed );
+        return D;
+    }
+
+}
@@ -0,0 +1,109 @@
+/*
+* Perspective module for scoped profiling zones.
+* PROFILE_SCOPE( "name" ) records begin and end of the enclosing scope into a
+* per-thread preallocated ring buffer; a collector dumps all threads as Chrome
+* trace / Perfetto JSON (chrome://tracing, ui.perfetto.dev).
+* Depends on Perspective::Timer.hpp, <iosfwd>
+* Zone costs two ProgramTime() readings, one buffer write and a push and a
+* pop of the zone stack. The readings dominate: the rest adds 5-10 ns.
+* Measured 50-55 ns with PER_TIME_TSC, 75-105 ns with steady_clock (35-45 ns
+* per reading) on Linux. Single load while disabled.
+* Open zones of every thread are also kept as a stack readable from other
+* threads (stall reports of a watchdog).
+* Buffers of finished threads are reused by new threads once a dump wrote
+* their events (or ClearProfile dropped them), so thread churn doesn't grow
+* memory as long as the profile is dumped or cleared.
+* Define PER_PROFILE_DISABLE to compile zones out.
+*/
+
+#pragma once
+
+// Standart dependencies: <iosfwd>
+#include <iosfwd>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+
+namespace Perspective
+{
+// ========================== External functions ============================
+
+    // amount of events kept per thread (the oldest are overwritten)
+    constexpr size_t PROFILE_EVENTS_PER_THREAD = 1 << 16;
+    // amount of open zones kept per thread (deeper zones are counted only)
+    constexpr size_t PROFILE_STACK_DEPTH = 32;
+
+    void SetProfilerEnabled( bool Enabled );  // zones cost a single load while disabled
+    bool IsProfilerEnabled();
+
+    // allocates ring buffer of current thread ahead of the first zone and
+    // gives the thread a name for the trace viewer. Optional: buffer is
+    // allocated by the first zone otherwise. Name must outlive the dump
+    void ProfileThreadInit( const char* Name = nullptr );
+
+    // writes events of all threads as Chrome trace JSON. Safe while threads
+    // keep recording: events overwritten during the dump are dropped. Events
+    // of finished threads are written once, their buffers are reused then.
+    // Returns amount of written events
+    size_t WriteChromeTrace( std::ostream& Out );
+    bool WriteChromeTrace( const char* Path );  // same into file. Returns false if the file can't be opened
+
+    // drops recorded events of all threads. Buffers are not written: the
+    // clear moment is kept and the dump skips older events
+    void ClearProfile();
+
+    // id of current thread in traces and for ReadProfileStack. Registers the thread
+    uint32_t ProfileThreadId();
+
+    // copies up to Max names of zones open in thread Tid, the outermost
+    // first. No allocations. Consistent only while the thread stays inside
+    // the zones (stalled), the innermost entry may be stale otherwise.
+    // Returns full depth of the stack (may exceed Max or PROFILE_STACK_DEPTH)
+    size_t ReadProfileStack( uint32_t Tid, const char** Out, size_t Max );
+
+    // records a complete zone. Name must be a string with static storage
+    void _ProfileRecord( const char* Name, const Duration& Begin, const Duration& End );
+    void _ProfileEnter( const char* Name );  // pushes zone onto the stack of current thread
+    void _ProfileLeave( const char* Name, const Duration& Begin, const Duration& End );  // pops and records
+
+    extern std::atomic<bool> _ProfilerEnabled;  // defined in .cpp
+
+// ============================ ProfileScope ================================
+
+    // RAII zone: samples ProgramTime() at construction and destruction.
+    // No allocations, no locks: two clock readings, one ring buffer write and
+    // a push and a pop of the zone stack
+    class ProfileScope
+    {
+    protected:
+        const char* Name;  // zone name, nullptr if the profiler was disabled on entry
+        Duration Begin;  // moment of zone entry
+    public:
+        explicit ProfileScope( const char* N )
+            : Name( _ProfilerEnabled.load( std::memory_order_relaxed ) ? N : nullptr )
+        {
+            if (Name)
+            {
+                _ProfileEnter( Name );
+                Begin = ProgramTime();
+            }
+        }
+        ~ProfileScope()
+        {
+            if (Name)
+                _ProfileLeave( Name, Begin, ProgramTime() );
+        }
+
+        ProfileScope( const ProfileScope& ) = delete;
+        ProfileScope& operator= ( const ProfileScope& ) = delete;
+    };
+}
+
+#define PER_PROFILE_CONCAT_( a, b ) a##b
+#define PER_PROFILE_CONCAT( a, b ) PER_PROFILE_CONCAT_( a, b )
+
+#ifndef PER_PROFILE_DISABLE
+#define PROFILE_SCOPE( name ) Perspective::ProfileScope PER_PROFILE_CONCAT( _profile_scope_, __LINE__ )( name )
+#else
+#define PROFILE_SCOPE( name ) ((void)0)
+#endif
@@ -0,0 +1,226 @@
+/* TimeBulk Realizations
+ * Depends on Perspective::Timer.hpp, <immintrin.h> on x86
+ */
+
+#include "TimeBulk.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PER_BULK_RUNTIME_DISPATCH  // kernels built with target attributes, chosen by CPUID
+#define PER_BULK_AVX2 __attribute__(( target( "avx2" ) ))
+#define PER_BULK_SSE41 __attribute__(( target( "sse4.1" ) ))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define PER_BULK_AVX2
+#define PER_BULK_SSE41
+#endif
+
+static_assert( sizeof( Perspective::Duration ) == sizeof( int64_t ), "bulk kernels read Durations as int64 arrays" );
+
+// ----------------------- Local utility functions --------------------------
+
+namespace
+{
+    using Perspective::Duration;
+
+    enum _BulkLevel { _BULK_SCALAR, _BULK_SSE41, _BULK_AVX2 };
+
+    _BulkLevel _SelectLevel()
+    {
+#if defined(PER_BULK_RUNTIME_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports( "avx2" ))
+            return _BULK_AVX2;
+        if (__builtin_cpu_supports( "sse4.1" ))
+            return _BULK_SSE41;
+        return _BULK_SCALAR;
+#elif defined(PER_BULK_AVX2)
+        return _BULK_AVX2;
+#else
+        return _BULK_SCALAR;
+#endif
+    }
+
+    _BulkLevel _Level()
+    {
+        static const _BulkLevel Level = _SelectLevel();
+        return Level;
+    }
+
+    template<class Real>
+    void _ConvertScalar( const int64_t* In, size_t N, Real* Out, double Scale )
+    {
+        for (size_t i = 0; i < N; i++)
+            Out[i] = Real( double( In[i] ) * Scale );
+    }
+
+#if defined(PER_BULK_AVX2)
+    // exact int64 -> double for the full range: high and low parts are
+    // placed into mantissas of magic doubles, a single rounding on the sum
+    PER_BULK_AVX2 inline __m256d _int64_to_pd( __m256i x )
+    {
+        __m256i High = _mm256_srai_epi32( x, 16 );
+        High = _mm256_blend_epi16( High, _mm256_setzero_si256(), 0x33 );
+        High = _mm256_add_epi64( High, _mm256_castpd_si256( _mm256_set1_pd( 442721857769029238784. ) ) );  // 3 * 2^67
+        __m256i Low = _mm256_blend_epi16( x, _mm256_castpd_si256( _mm256_set1_pd( 4503599627370496. ) ), 0x88 );  // 2^52
+        __m256d f = _mm256_sub_pd( _mm256_castsi256_pd( High ), _mm256_set1_pd( 442726361368656609280. ) );  // 3 * 2^67 + 2^52
+        return _mm256_add_pd( f, _mm256_castsi256_pd( Low ) );
+    }
+
+    PER_BULK_AVX2 void _ConvertAVX2( const int64_t* In, size_t N, double* Out, double Scale )
+    {
+        __m256d S = _mm256_set1_pd( Scale );
+        size_t i = 0;
+        for (; i + 4 <= N; i += 4)
+            _mm256_storeu_pd( Out + i, _mm256_mul_pd( _int64_to_pd( _mm256_loadu_si256( (const __m256i*)(In + i) ) ), S ) );
+        _ConvertScalar( In + i, N - i, Out + i, Scale );
+    }
+
+    PER_BULK_AVX2 void _ConvertAVX2( const int64_t* In, size_t N, float* Out, double Scale )
+    {
+        __m256d S = _mm256_set1_pd( Scale );
+        size_t i = 0;
+        for (; i + 8 <= N; i += 8)
+        {
+            __m128 a = _mm256_cvtpd_ps( _mm256_mul_pd( _int64_to_pd( _mm256_loadu_si256( (const __m256i*)(In + i) ) ), S ) );
+            __m128 b = _mm256_cvtpd_ps( _mm256_mul_pd( _int64_to_pd( _mm256_loadu_si256( (const __m256i*)(In + i + 4) ) ), S ) );
+            _mm256_storeu_ps( Out + i, _mm256_set_m128( b, a ) );
+        }
+        _ConvertScalar( In + i, N - i, Out + i, Scale );
+    }
+
+    PER_BULK_AVX2 Perspective::DurationSummary _SummarizeAVX2( const int64_t* In, size_t N )
+    {
+        __m256i Sum = _mm256_setzero_si256();
+        __m256i Min = _mm256_set1_epi64x( Perspective::MAX_TICK );
+        __m256i Max = _mm256_set1_epi64x( Perspective::MIN_TICK );
+        size_t i = 0;
+        for (; i + 4 <= N; i += 4)
+        {
+            __m256i v = _mm256_loadu_si256( (const __m256i*)(In + i) );
+            Sum = _mm256_add_epi64( Sum, v );
+            Min = _mm256_blendv_epi8( Min, v, _mm256_cmpgt_epi64( Min, v ) );
+            Max = _mm256_blendv_epi8( Max, v, _mm256_cmpgt_epi64( v, Max ) );
+        }
+        alignas( 32 ) int64_t s[4], lo[4], hi[4];
+        _mm256_store_si256( (__m256i*)s, Sum );
+        _mm256_store_si256( (__m256i*)lo, Min );
+        _mm256_store_si256( (__m256i*)hi, Max );
+        uint64_t Total = uint64_t( s[0] ) + uint64_t( s[1] ) + uint64_t( s[2] ) + uint64_t( s[3] );  // wraps, not UB
+        int64_t Lowest = lo[0], Highest = hi[0];
+        for (int k = 1; k < 4; k++)
+        {
+            Lowest = lo[k] < Lowest ? lo[k] : Lowest;
+            Highest = hi[k] > Highest ? hi[k] : Highest;
+        }
+        for (; i < N; i++)
+        {
+            Total += uint64_t( In[i] );
+            Lowest = In[i] < Lowest ? In[i] : Lowest;
+            Highest = In[i] > Highest ? In[i] : Highest;
+        }
+        return { N, Duration( int64_t( Total ) ), Duration( Lowest ), Duration( Highest ), Perspective::ZERO_Duration };
+    }
+#endif
+
+#if defined(PER_BULK_SSE41)
+    PER_BULK_SSE41 inline __m128d _int64_to_pd( __m128i x )
+    {
+        __m128i High = _mm_srai_epi32( x, 16 );
+        High = _mm_blend_epi16( High, _mm_setzero_si128(), 0x33 );
+        High = _mm_add_epi64( High, _mm_castpd_si128( _mm_set1_pd( 442721857769029238784. ) ) );
+        __m128i Low = _mm_blend_epi16( x, _mm_castpd_si128( _mm_set1_pd( 4503599627370496. ) ), 0x88 );
+        __m128d f = _mm_sub_pd( _mm_castsi128_pd( High ), _mm_set1_pd( 442726361368656609280. ) );
+        return _mm_add_pd( f, _mm_castsi128_pd( Low ) );
+    }
+
+    PER_BULK_SSE41 void _ConvertSSE41( const int64_t* In, size_t N, double* Out, double Scale )
+    {
+        __m128d S = _mm_set1_pd( Scale );
+        size_t i = 0;
+        for (; i + 2 <= N; i += 2)
+            _mm_storeu_pd( Out + i, _mm_mul_pd( _int64_to_pd( _mm_loadu_si128( (const __m128i*)(In + i) ) ), S ) );
+        _ConvertScalar( In + i, N - i, Out + i, Scale );
+    }
+
+    PER_BULK_SSE41 void _ConvertSSE41( const int64_t* In, size_t N, float* Out, double Scale )
+    {
+        __m128d S = _mm_set1_pd( Scale );
+        size_t i = 0;
+        for (; i + 4 <= N; i += 4)
+        {
+            __m128 a = _mm_cvtpd_ps( _mm_mul_pd( _int64_to_pd( _mm_loadu_si128( (const __m128i*)(In + i) ) ), S ) );
+            __m128 b = _mm_cvtpd_ps( _mm_mul_pd( _int64_to_pd( _mm_loadu_si128( (const __m128i*)(In + i + 2) ) ), S ) );
+            _mm_storeu_ps( Out + i, _mm_movelh_ps( a, b ) );
+        }
+        _ConvertScalar( In + i, N - i, Out + i, Scale );
+    }
+#endif
+
+    // SSE4.1 has no 64-bit compare: summary is scalar below AVX2
+    Perspective::DurationSummary _SummarizeScalar( const int64_t* In, size_t N )
+    {
+        uint64_t Total = 0;
+        int64_t Lowest = Perspective::MAX_TICK, Highest = Perspective::MIN_TICK;
+        for (size_t i = 0; i < N; i++)
+        {
+            Total += uint64_t( In[i] );
+            Lowest = In[i] < Lowest ? In[i] : Lowest;
+            Highest = In[i] > Highest ? In[i] : Highest;
+        }
+        return { N, Duration( int64_t( Total ) ), Duration( Lowest ), Duration( Highest ), Perspective::ZERO_Duration };
+    }
+
+    template<class Real>
+    void _Convert( const Duration* In, size_t N, Real* Out, double Scale )
+    {
+        const int64_t* Ticks = (const int64_t*)In;
+        switch (_Level())
+        {
+#if defined(PER_BULK_AVX2)
+        case _BULK_AVX2: _ConvertAVX2( Ticks, N, Out, Scale ); return;
+#endif
+#if defined(PER_BULK_SSE41)
+        case _BULK_SSE41: _ConvertSSE41( Ticks, N, Out, Scale ); return;
+#endif
+        default: _ConvertScalar( Ticks, N, Out, Scale ); return;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------
+
+namespace Perspective
+{
+
+    void ConvertToSec( const Duration* In, size_t N, double* Out ) { _Convert( In, N, Out, SEC_PER_TICK ); }
+    void ConvertToSec( const Duration* In, size_t N, float* Out ) { _Convert( In, N, Out, SEC_PER_TICK ); }
+    void ConvertToMilliSec( const Duration* In, size_t N, double* Out ) { _Convert( In, N, Out, MSEC_PER_TICK ); }
+    void ConvertToMilliSec( const Duration* In, size_t N, float* Out ) { _Convert( In, N, Out, MSEC_PER_TICK ); }
+    void ConvertToMicroSec( const Duration* In, size_t N, double* Out ) { _Convert( In, N, Out, USEC_PER_TICK ); }
+    void ConvertToMicroSec( const Duration* In, size_t N, float* Out ) { _Convert( In, N, Out, USEC_PER_TICK ); }
+
+    DurationSummary SummarizeDurations( const Duration* In, size_t N )
+    {
+        const int64_t* Ticks = (const int64_t*)In;
+#if defined(PER_BULK_AVX2)
+        DurationSummary S = _Level() == _BULK_AVX2 ? _SummarizeAVX2( Ticks, N ) : _SummarizeScalar( Ticks, N );
+#else
+        DurationSummary S = _SummarizeScalar( Ticks, N );
+#endif
+        if (N)
+            S.Mean = Duration( S.Sum.getTicks() / time_tick_t( N ) );
+        return S;
+    }
+
+    const char* GetBulkKernel()
+    {
+        switch (_Level())
+        {
+        case _BULK_AVX2: return "avx2";
+        case _BULK_SSE41: return "sse4.1";
+        default: return "scalar";
+        }
+    }
+
+}
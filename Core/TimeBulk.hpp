@@ -0,0 +1,42 @@
+/*
+* Perspective module for bulk processing of Duration arrays.
+* Converts whole arrays of Durations into real milliseconds, microseconds or
+* seconds and summarizes them (sum, min, max, mean) in one pass. AVX2 and
+* SSE4.1 kernels are selected at runtime on x86 (GCC, Clang) or at compile
+* time (MSVC with /arch:AVX2), scalar code is used elsewhere.
+* Results may differ from Duration::as*() in the last bit: conversions
+* multiply by a reciprocal instead of dividing.
+* Depends on Perspective::Timer.hpp
+*/
+
+#pragma once
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+
+namespace Perspective
+{
+// ========================== External functions ============================
+
+    // Out[i] = In[i] in given units. In and Out may not overlap
+    void ConvertToSec( const Duration* In, size_t N, double* Out );
+    void ConvertToSec( const Duration* In, size_t N, float* Out );
+    void ConvertToMilliSec( const Duration* In, size_t N, double* Out );
+    void ConvertToMilliSec( const Duration* In, size_t N, float* Out );
+    void ConvertToMicroSec( const Duration* In, size_t N, double* Out );
+    void ConvertToMicroSec( const Duration* In, size_t N, float* Out );
+
+    // one-pass summary of a Duration array
+    struct DurationSummary
+    {
+        size_t Count;  // amount of summarized intervals
+        Duration Sum;  // wraps around on overflow (292 years of nanosecond ticks)
+        Duration Min;  // MAX_Duration if empty
+        Duration Max;  // MIN_Duration if empty
+        Duration Mean;  // truncated towards zero, ZERO_Duration if empty
+    };
+
+    DurationSummary SummarizeDurations( const Duration* In, size_t N );
+
+    const char* GetBulkKernel();  // name of selected kernel: "avx2", "sse4.1" or "scalar"
+}
@@ -0,0 +1,122 @@
+/* TimeCoroutines Realizations
+ * Depends on Perspective::TimeUtils.hpp, <algorithm>
+ */
+
+#include "TimeCoroutines.hpp"
+
+#if defined(__cpp_impl_coroutine)
+
+// Standart dependencies: <algorithm>, <functional>
+#include <algorithm>  // heap operations
+#include <functional>  // std::greater
+
+namespace Perspective
+{
+namespace Async
+{
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Awaitables ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    void Task::promise_type::_Final::await_suspend( std::coroutine_handle<promise_type> H ) noexcept
+    {
+        if (H.promise().Exec)
+            H.promise().Exec->_Finished( H.promise().Error );
+        H.destroy();
+    }
+
+    void _SleepAwaiter::await_suspend( std::coroutine_handle<Task::promise_type> H ) const
+    {
+        H.promise().Exec->_Sleep( H, Deadline );
+    }
+
+    void _TickAwaiter::await_suspend( std::coroutine_handle<Task::promise_type> H ) const
+    {
+        H.promise().Exec->Ready.push_back( H );
+    }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Executor ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    Executor::~Executor()
+    {
+        for (_Sleeper& S : Sleepers)
+            S.Handle.destroy();
+        for (auto H : Ready)
+            H.destroy();
+        for (auto H : Resuming)  // not yet resumed if destroyed from inside Poll
+            if (H)
+                H.destroy();
+    }
+
+    void Executor::_Sleep( std::coroutine_handle<Task::promise_type> H, const Duration& Deadline )
+    {
+        if (Deadline <= ProgramTime())  // already reached: the next Poll, after the others
+        {
+            Ready.push_back( H );
+            return;
+        }
+        Sleepers.push_back( _Sleeper{ Deadline.getTicks(), Order++, H } );
+        std::push_heap( Sleepers.begin(), Sleepers.end(), std::greater<_Sleeper>() );
+    }
+
+    void Executor::Spawn( Task T )
+    {
+        T.Handle.promise().Exec = this;
+        Ready.push_back( T.Handle );
+        T.Handle = nullptr;  // owned by the executor now
+        Alive++;
+    }
+
+    size_t Executor::Poll()
+    {
+        size_t Resumed = 0;
+
+        // tasks which yield again during this Poll go to the next one
+        Resuming.swap( Ready );
+        for (size_t i = 0; i < Resuming.size(); i++)
+        {
+            auto H = Resuming[i];
+            Resuming[i] = nullptr;
+            H.resume();
+            Resumed++;
+        }
+        Resuming.clear();
+
+        // deadlines up to the moment of the call: new sleeps always land later
+        time_tick_t Now = ProgramTime().getTicks();
+        while (!Sleepers.empty() && Sleepers.front().Deadline <= Now)
+        {
+            std::pop_heap( Sleepers.begin(), Sleepers.end(), std::greater<_Sleeper>() );
+            auto H = Sleepers.back().Handle;
+            Sleepers.pop_back();
+            H.resume();
+            Resumed++;
+        }
+
+        if (Failure)
+        {
+            std::exception_ptr Error = Failure;
+            Failure = nullptr;
+            std::rethrow_exception( Error );
+        }
+        return Resumed;
+    }
+
+    void Executor::Run()
+    {
+        while (Alive)
+        {
+            Poll();
+            if (Ready.empty() && !Sleepers.empty())
+                Perspective::SleepUntil( NextDeadline() );
+        }
+    }
+
+    Duration Executor::NextDeadline() const
+    {
+        return Sleepers.empty() ? MAX_Duration : Duration( Sleepers.front().Deadline );
+    }
+
+}
+}
+
+#endif
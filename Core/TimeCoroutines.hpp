@@ -0,0 +1,169 @@
+/*
+* Perspective module for timed waits in C++20 coroutines.
+* Gameplay scripts suspend with co_await Async::SleepFor( d ), SleepUntil( t )
+* or NextTick() instead of polling Expectant or Repeater objects; a single
+* Async::Executor resumes any amount of them from a deadline queue ordered by
+* ProgramTime(), so the installed TimeSource (VirtualClock) is followed too.
+* Awaitables live in Perspective::Async: blocking SleepUntil() of TimeUtils
+* takes the same arguments.
+* Depends on Perspective::TimeUtils.hpp, <coroutine>, <vector>
+* Compiled only with coroutine support (-std=c++20), empty otherwise.
+*/
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine)
+
+// Standart dependencies: <coroutine>, <exception>, <vector>
+#include <coroutine>
+#include <exception>
+#include <vector>
+
+// ------------------------- Project dependencies ---------------------------
+#include "TimeUtils.hpp"
+
+namespace Perspective
+{
+namespace Async
+{
+    class Executor;
+    struct _SleepAwaiter;
+    struct _TickAwaiter;
+
+// ================================= Task ===================================
+
+    // Class Task - return type of a timed coroutine. Starts suspended, runs
+    // after Executor::Spawn(), its frame is destroyed when it finishes (or
+    // with the executor). Can await SleepFor, SleepUntil and NextTick only.
+    // An exception escaping the coroutine finishes it and is rethrown by
+    // the Executor::Poll() which resumed it
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            Executor* Exec = nullptr;  // set by Spawn
+            std::exception_ptr Error;  // escaped exception, passed to the executor on finish
+
+            Task get_return_object() { return Task( std::coroutine_handle<promise_type>::from_promise( *this ) ); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            // notifies the executor, then lets the frame be destroyed
+            struct _Final
+            {
+                bool await_ready() noexcept { return false; }
+                void await_suspend( std::coroutine_handle<promise_type> H ) noexcept;
+                void await_resume() noexcept {}
+            };
+            _Final final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+            void unhandled_exception() { Error = std::current_exception(); }  // final_suspend still runs
+
+            // the only awaitables: anything else would suspend without being
+            // queued and hang Executor::Run(), so it does not compile
+            _SleepAwaiter await_transform( const _SleepAwaiter& A ) const noexcept;
+            _TickAwaiter await_transform( const _TickAwaiter& A ) const noexcept;
+        };
+
+        Task( Task&& T ) noexcept : Handle( T.Handle ) { T.Handle = nullptr; }
+        Task& operator= ( Task&& ) = delete;
+        ~Task() { if (Handle) Handle.destroy(); }  // never spawned
+
+    protected:
+        friend class Executor;
+        std::coroutine_handle<promise_type> Handle;
+
+        explicit Task( std::coroutine_handle<promise_type> H ) : Handle( H ) {}
+    };
+
+// ============================== Awaitables ================================
+
+    // suspends until a moment since program start. A deadline already
+    // reached still suspends till the next Poll, so zero sleeps yield
+    struct _SleepAwaiter
+    {
+        Duration Deadline;
+
+        bool await_ready() const { return false; }
+        void await_suspend( std::coroutine_handle<Task::promise_type> H ) const;
+        void await_resume() const {}
+    };
+
+    // suspends until the next Executor::Poll()
+    struct _TickAwaiter
+    {
+        bool await_ready() const { return false; }
+        void await_suspend( std::coroutine_handle<Task::promise_type> H ) const;
+        void await_resume() const {}
+    };
+
+    inline _SleepAwaiter SleepFor( const Duration& Delay ) { return _SleepAwaiter{ ProgramTime() + Delay }; }
+    inline _SleepAwaiter SleepUntil( const Duration& Moment ) { return _SleepAwaiter{ Moment }; }  // moment since program start
+    inline _SleepAwaiter SleepUntil( const Time& Moment ) { return _SleepAwaiter{ Moment - Time() }; }
+    inline _TickAwaiter NextTick() { return _TickAwaiter{}; }
+
+    inline _SleepAwaiter Task::promise_type::await_transform( const _SleepAwaiter& A ) const noexcept { return A; }
+    inline _TickAwaiter Task::promise_type::await_transform( const _TickAwaiter& A ) const noexcept { return A; }
+
+// =============================== Executor =================================
+
+    // Class Executor - resumes suspended Tasks on the calling thread. Poll()
+    // fits into a frame loop, Run() drives coroutines alone (servers, tests).
+    // Not thread-safe: Spawn, Poll and Run are called by a single thread
+    class Executor
+    {
+    protected:
+        friend struct _SleepAwaiter;
+        friend struct _TickAwaiter;
+        friend struct Task::promise_type::_Final;
+
+        struct _Sleeper
+        {
+            time_tick_t Deadline;
+            uint64_t Order;  // FIFO among equal deadlines
+            std::coroutine_handle<Task::promise_type> Handle;
+
+            bool operator> ( const _Sleeper& S ) const { return Deadline != S.Deadline ? Deadline > S.Deadline : Order > S.Order; }
+        };
+
+        std::vector<_Sleeper> Sleepers;  // min-heap by deadline
+        std::vector<std::coroutine_handle<Task::promise_type>> Ready;  // resumed by the next Poll
+        std::vector<std::coroutine_handle<Task::promise_type>> Resuming;  // Ready taken by the current Poll
+        uint64_t Order = 0;
+        size_t Alive = 0;  // spawned and not finished tasks
+        std::exception_ptr Failure;  // the first exception escaped a task during the current Poll
+
+        void _Sleep( std::coroutine_handle<Task::promise_type> H, const Duration& Deadline );
+        void _Finished( std::exception_ptr Error )
+        {
+            Alive--;
+            if (Error && !Failure)
+                Failure = Error;
+        }
+    public:
+        Executor() = default;
+        ~Executor();  // destroys frames of unfinished tasks
+
+        Executor( const Executor& ) = delete;
+        Executor& operator= ( const Executor& ) = delete;
+
+        void Spawn( Task T );  // task starts running on the next Poll
+
+        // resumes spawned tasks, NextTick waiters and sleepers with deadlines
+        // up to now. Returns amount of resumptions. Rethrows the first
+        // exception escaped a task once all resumptions are done
+        size_t Poll();
+
+        // polls until all tasks finish, sleeping (TimeUtils SleepUntil) to the
+        // nearest deadline in between. Exceptions of tasks pass through, the
+        // remaining tasks continue on the next Run
+        void Run();
+
+        inline size_t Size() const { return Alive; }  // amount of unfinished tasks
+        Duration NextDeadline() const;  // nearest sleeper deadline, MAX_Duration if none
+    };
+}
+}
+
+#endif
@@ -0,0 +1,115 @@
+/* TimeFormat Realizations
+ * Depends on Perspective::Timer.hpp
+ */
+
+#include "TimeFormat.hpp"
+
+// Standart dependencies: <cstring>
+#include <string.h>  // memcpy
+
+// ----------------------- Local utility functions --------------------------
+
+namespace
+{
+    // "YYYY-MM-DDTHH:MM:SS" of the last formatted second
+    struct _StampCache
+    {
+        time_t Sec;  // cached second
+        bool Valid;  // false until the first stamp
+        char Prefix[19];  // formatted date and time
+    };
+
+    // zero-initialized, so no thread_local construction guards on access
+    thread_local _StampCache _LocalCache;
+    thread_local _StampCache _UTCCache;
+
+    const char _Digits2[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    const Perspective::time_int64_t _Pow10[] =
+        { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+    inline void _put2( char* P, int V ) { memcpy( P, _Digits2 + V * 2, 2 ); }
+
+    // rebuilds cached prefix for a new second. Returns false if the year
+    // doesn't fit 4 digits or the moment can't be broken down
+    bool _fill_prefix( _StampCache& C, time_t Sec, bool UTC )
+    {
+        tm Tm;
+#ifdef _WIN32
+        if ((UTC ? gmtime_s( &Tm, &Sec ) : localtime_s( &Tm, &Sec )) != 0)
+            return false;
+#else
+        if (!(UTC ? gmtime_r( &Sec, &Tm ) : localtime_r( &Sec, &Tm )))
+            return false;
+#endif
+        int Year = Tm.tm_year + 1900;
+        if (Year < 0 || Year > 9999)
+            return false;
+        _put2( C.Prefix, (Year / 100) % 100 );
+        _put2( C.Prefix + 2, Year % 100 );
+        C.Prefix[4] = '-';
+        _put2( C.Prefix + 5, Tm.tm_mon + 1 );
+        C.Prefix[7] = '-';
+        _put2( C.Prefix + 8, Tm.tm_mday );
+        C.Prefix[10] = 'T';
+        _put2( C.Prefix + 11, Tm.tm_hour );
+        C.Prefix[13] = ':';
+        _put2( C.Prefix + 14, Tm.tm_min );
+        C.Prefix[16] = ':';
+        _put2( C.Prefix + 17, Tm.tm_sec );
+        C.Sec = Sec;
+        C.Valid = true;
+        return true;
+    }
+}
+
+// --------------------------------------------------------------------------
+
+namespace Perspective
+{
+
+    size_t FormatISO8601( const Time& T, char* Buf, size_t Size, int Digits, bool UTC )
+    {
+        if (Digits < 0) Digits = 0;
+        if (Digits > 9) Digits = 9;
+        size_t Len = 19 + (Digits ? Digits + 1 : 0) + (UTC ? 1 : 0);
+        if (Size <= Len)
+            return 0;
+
+        // floor division - correct for moments before epoch
+        time_tick_t Sec = T.getTicks() / TICKS_PER_SEC;
+        time_tick_t Sub = T.getTicks() % TICKS_PER_SEC;
+        if (Sub < 0)
+        {
+            --Sec;
+            Sub += TICKS_PER_SEC;
+        }
+
+        _StampCache& C = UTC ? _UTCCache : _LocalCache;
+        if (!C.Valid || C.Sec != (time_t)Sec)
+            if (!_fill_prefix( C, (time_t)Sec, UTC ))
+                return 0;
+        memcpy( Buf, C.Prefix, 19 );
+
+        char* P = Buf + 19;
+        if (Digits)
+        {
+            time_int64_t Frac = time_int64_t( Sub ) * _Pow10[Digits] / TICKS_PER_SEC;
+            *P = '.';
+            for (int i = Digits; i > 0; --i)
+            {
+                P[i] = char( '0' + Frac % 10 );
+                Frac /= 10;
+            }
+            P += Digits + 1;
+        }
+        if (UTC)
+            *P++ = 'Z';
+        *P = 0;
+        return Len;
+    }
+
+}
@@ -0,0 +1,36 @@
+/*
+* Perspective module for fast thread-safe timestamp formatting.
+* Writes into caller-provided buffers, never touches shared state.
+* Depends on Perspective::Timer.hpp
+*/
+
+#pragma once
+
+// Standart dependencies: <cstddef>
+#include <stddef.h>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+
+namespace Perspective
+{
+// ========================== External functions ============================
+
+    // buffer size enough for any stamp produced by FormatISO8601
+    constexpr size_t ISO8601_BUFFER_SIZE = 32;
+
+    // Formats moment of time as ISO-8601 stamp "YYYY-MM-DDTHH:MM:SS[.fff][Z]"
+    // into caller-provided buffer and terminates it with zero. Digits is an
+    // amount of sub-second digits (0..9), taken from the tick count. If UTC
+    // is set - formats UTC time with 'Z' suffix, local time otherwise.
+    // Broken-down date is cached per thread and per second, so only the first
+    // stamp of every second calls localtime/gmtime. Lock-free and thread-safe.
+    // Returns amount of written chars (without terminator) or 0 if the buffer
+    // is too small or the year is out of 0000..9999.
+    size_t FormatISO8601( const Time& T, char* Buf, size_t Size, int Digits = 3, bool UTC = false );
+
+    // Duration is not a moment of time (ProgramTime() counts from program
+    // start, not from the Unix epoch): convert explicitly, e.g.
+    // FormatISO8601( StartMoment() + Dur, ... )
+    size_t FormatISO8601( const Duration& Dur, char* Buf, size_t Size, int Digits = 3, bool UTC = false ) = delete;
+}
@@ -0,0 +1,110 @@
+/* TimeHistogram Realizations
+ * Depends on Perspective::Timer.hpp, <thread>
+ */
+
+#include "TimeHistogram.hpp"
+
+// Standart dependencies: <thread>
+#include <thread>
+
+namespace Perspective
+{
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ HistogramSnapshot ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    void HistogramSnapshot::Merge( const HistogramSnapshot& S )
+    {
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+            Counts[b] += S.Counts[b];
+        Total += S.Total;
+    }
+
+    Duration HistogramSnapshot::Min() const
+    {
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+            if (Counts[b])
+                return Duration( _histogram_lower( b ) );
+        return ZERO_Duration;
+    }
+
+    Duration HistogramSnapshot::Max() const
+    {
+        for (size_t b = HISTOGRAM_BUCKETS; b-- > 0;)
+            if (Counts[b])
+                return Duration( _histogram_upper( b ) );
+        return ZERO_Duration;
+    }
+
+    Duration HistogramSnapshot::Mean() const
+    {
+        if (!Total)
+            return ZERO_Duration;
+        time_real_t Sum = 0;
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+            if (Counts[b])
+                Sum += time_real_t( Counts[b] ) * (time_real_t( _histogram_lower( b ) ) + time_real_t( _histogram_upper( b ) )) / 2;
+        return Duration( time_tick_t( Sum / Total + 0.5 ) );
+    }
+
+    Duration HistogramSnapshot::Percentile( double P ) const
+    {
+        if (!Total)
+            return ZERO_Duration;
+        if (P <= 0)
+            return Min();
+        uint64_t Rank = uint64_t( P / 100 * Total + 0.999999 );  // amount of intervals not exceeding result
+        if (Rank > Total)
+            Rank = Total;
+        uint64_t Seen = 0;
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+        {
+            Seen += Counts[b];
+            if (Seen >= Rank)
+                return Duration( _histogram_upper( b ) );
+        }
+        return Max();
+    }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ LatencyHistogram ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    thread_local unsigned _HistogramSlot = 0;
+
+    unsigned _HistogramThreadSlot()
+    {
+        static std::atomic<unsigned> Next{ 1 };
+        return _HistogramSlot = Next.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    LatencyHistogram::LatencyHistogram( unsigned ShardsN )
+    {
+        if (!ShardsN)
+            ShardsN = std::thread::hardware_concurrency();
+        unsigned N = 1;
+        while (N < ShardsN && N < 256)
+            N <<= 1;
+        Shards.reset( new _Shard[N] );
+        ShardMask = N - 1;
+        Reset();
+    }
+
+    HistogramSnapshot LatencyHistogram::Read() const
+    {
+        HistogramSnapshot S;
+        for (unsigned i = 0; i <= ShardMask; i++)
+            for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+            {
+                uint64_t N = Shards[i].Counts[b].load( std::memory_order_relaxed );
+                if (N)
+                    S.Add( b, N );
+            }
+        return S;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        for (unsigned i = 0; i <= ShardMask; i++)
+            for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+                Shards[i].Counts[b].store( 0, std::memory_order_relaxed );
+    }
+
+}
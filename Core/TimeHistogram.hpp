@@ -0,0 +1,142 @@
+/*
+* Perspective module for latency histograms.
+* Log-linear (HDR-style) buckets: every power of two of ticks is split into
+* HISTOGRAM_SUB_BUCKETS linear buckets, so relative error of any query is
+* below 1 / HISTOGRAM_SUB_BUCKETS (~3%), exact for intervals below 64 ticks.
+* Record is a single relaxed atomic increment into the shard of the calling
+* thread; shards are merged on read.
+* Depends on Perspective::Timer.hpp, <atomic>, <memory>, <array>
+*/
+
+#pragma once
+
+// Standart dependencies: <atomic>, <memory>, <array>
+#include <atomic>
+#include <memory>
+#include <array>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+
+namespace Perspective
+{
+// ============================ Bucket layout ===============================
+
+    constexpr int HISTOGRAM_SUB_BITS = 5;
+    constexpr time_int64_t HISTOGRAM_SUB_BUCKETS = time_int64_t( 1 ) << HISTOGRAM_SUB_BITS;  // linear buckets per power of two
+    constexpr int HISTOGRAM_MAX_BITS = 44;  // longer intervals fall into the last bucket (~4.8 hours of nanosecond ticks)
+    constexpr size_t HISTOGRAM_BUCKETS = size_t( (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS );
+
+    // index of the highest set bit, v > 0
+    inline int _histogram_msb( uint64_t v )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll( v );
+#else
+        int b = 0;
+        while (v >>= 1)
+            b++;
+        return b;
+#endif
+    }
+
+    // bucket of an interval of t ticks. Negative intervals go to the first bucket
+    inline size_t _histogram_bucket( time_tick_t t )
+    {
+        if (t < 2 * HISTOGRAM_SUB_BUCKETS)
+            return t > 0 ? size_t( t ) : 0;
+        uint64_t v = uint64_t( t );
+        if (v >> HISTOGRAM_MAX_BITS)
+            return HISTOGRAM_BUCKETS - 1;
+        int shift = _histogram_msb( v ) - HISTOGRAM_SUB_BITS;
+        return size_t( shift * HISTOGRAM_SUB_BUCKETS + (v >> shift) );
+    }
+
+    // smallest interval in ticks falling into bucket
+    inline time_tick_t _histogram_lower( size_t b )
+    {
+        if (b < size_t( 2 * HISTOGRAM_SUB_BUCKETS ))
+            return time_tick_t( b );
+        int shift = int( b / HISTOGRAM_SUB_BUCKETS ) - 1;
+        return time_tick_t( (b % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS) << shift );
+    }
+
+    // largest interval in ticks falling into bucket
+    inline time_tick_t _histogram_upper( size_t b )
+    {
+        if (b < size_t( 2 * HISTOGRAM_SUB_BUCKETS ))
+            return time_tick_t( b );
+        return _histogram_lower( b ) + (time_tick_t( 1 ) << (b / HISTOGRAM_SUB_BUCKETS - 1)) - 1;
+    }
+
+// ========================== HistogramSnapshot =============================
+
+    // Class HistogramSnapshot - plain copy of histogram counts for queries.
+    // Snapshots of different histograms can be merged
+    class HistogramSnapshot
+    {
+    protected:
+        std::array<uint64_t, HISTOGRAM_BUCKETS> Counts;  // amount of intervals per bucket
+        uint64_t Total;  // sum of Counts
+    public:
+        HistogramSnapshot() : Counts(), Total( 0 ) {}
+
+        void Add( size_t Bucket, uint64_t N ) { Counts[Bucket] += N; Total += N; }
+        void Merge( const HistogramSnapshot& S );
+
+        uint64_t Count() const { return Total; }  // amount of recorded intervals
+        uint64_t BucketCount( size_t Bucket ) const { return Counts[Bucket]; }
+        Duration Min() const;  // ZERO_Duration if empty
+        Duration Max() const;
+        Duration Mean() const;  // uses bucket midpoints
+        Duration Percentile( double P ) const;  // P in [0, 100]. Upper bound of the bucket holding P-th percentile
+    };
+
+// =========================== LatencyHistogram =============================
+
+    // returns small index of calling thread, assigned on the first call
+    unsigned _HistogramThreadSlot();
+    extern thread_local unsigned _HistogramSlot;  // 0 until assigned, defined in .cpp
+
+    // Class LatencyHistogram - concurrent histogram of Durations. Every thread
+    // writes into its own shard (threads share shards if there are more of
+    // them than shards), so recording doesn't bounce cache lines.
+    // Query cost is proportional to Shards * HISTOGRAM_BUCKETS
+    class LatencyHistogram
+    {
+    protected:
+        struct alignas(64) _Shard
+        {
+            std::atomic<uint64_t> Counts[HISTOGRAM_BUCKETS];
+        };
+
+        std::unique_ptr<_Shard[]> Shards;
+        unsigned ShardMask;  // amount of shards - 1
+    public:
+        explicit LatencyHistogram( unsigned ShardsN = 0 );  // 0 - one per hardware thread. Rounded up to power of two
+
+        LatencyHistogram( const LatencyHistogram& ) = delete;
+        LatencyHistogram& operator= ( const LatencyHistogram& ) = delete;
+
+        // no locks, no allocations: one relaxed increment
+        void Record( const Duration& dt )
+        {
+            unsigned Slot = _HistogramSlot;
+            if (!Slot)
+                Slot = _HistogramThreadSlot();
+            Shards[Slot & ShardMask].Counts[_histogram_bucket( dt.getTicks() )].fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        HistogramSnapshot Read() const;  // merges all shards. Concurrent records may or may not be included
+        void Reset();  // not atomic with concurrent records
+
+        unsigned GetShards() const { return ShardMask + 1; }
+
+        // shortcuts of Read()
+        uint64_t Count() const { return Read().Count(); }
+        Duration Min() const { return Read().Min(); }
+        Duration Max() const { return Read().Max(); }
+        Duration Mean() const { return Read().Mean(); }
+        Duration Percentile( double P ) const { return Read().Percentile( P ); }
+    };
+}
@@ -0,0 +1,275 @@
+/* TimeStream Realizations
+ * Depends on Perspective::Timer.hpp, <vector>, <cstring>, <algorithm>
+ */
+
+#include "TimeStream.hpp"
+
+// Standart dependencies: <cstring>, <algorithm>
+#include <cstring>  // memcpy
+#include <algorithm>  // std::min
+
+// ----------------------- Local utility functions --------------------------
+
+namespace
+{
+    const uint8_t _TS_MAGIC[3] = { 'P', 'T', 'S' };
+    const uint8_t _TS_TRAILER_MAGIC[4] = { 'P', 'T', 'S', 'I' };
+    const uint8_t _TS_VERSION = 1;
+    const uint8_t _TS_FLAG_DOD = 1;  // deltas of deltas
+    const size_t _TS_TRAILER = 8 + 8 + 4;  // Count, IndexOffset, magic
+
+    void _put_u64( std::vector<uint8_t>& Out, uint64_t v )
+    {
+        for (int i = 0; i < 8; i++)
+            Out.push_back( uint8_t( v >> (8 * i) ) );
+    }
+
+    uint64_t _get_u64( const uint8_t* P )
+    {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; i--)
+            v = (v << 8) | P[i];
+        return v;
+    }
+
+    // index of the lowest set bit, v != 0
+    inline int _lowest_bit( uint64_t v )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll( v );
+#else
+        int b = 0;
+        while (!(v & 1))
+        {
+            v >>= 1;
+            b++;
+        }
+        return b;
+#endif
+    }
+
+    // decodes N varints into Raw. Runs of 8 single-byte varints, the usual
+    // case for regular stamps, are taken a word at a time
+    bool _varint_run( const uint8_t*& P, const uint8_t* End, uint64_t* Raw, size_t N )
+    {
+        size_t i = 0;
+        while (i < N)
+        {
+            uint64_t Word = 0;
+            if (End - P >= 8)
+                memcpy( &Word, P, 8 );  // little endian byte order assumed, as everywhere in the stream
+            if (N - i >= 8 && End - P >= 8 && !(Word & 0x8080808080808080ull))
+            {
+                for (int k = 0; k < 8; k++)
+                    Raw[i + k] = P[k];
+                P += 8;
+                i += 8;
+                continue;
+            }
+            if (End - P >= 8 && (Word & 0x8080808080808080ull) != 0x8080808080808080ull)
+            {
+                // varint of up to 8 bytes within the loaded word: no per-byte bounds checks
+                uint64_t Stops = ~Word & 0x8080808080808080ull;
+                int Length = _lowest_bit( Stops ) / 8 + 1;
+                uint64_t v = 0;
+                for (int k = 0; k < Length; k++)
+                    v |= ((Word >> (8 * k)) & 0x7F) << (7 * k);
+                Raw[i++] = v;
+                P += Length;
+                continue;
+            }
+            if (!Perspective::_varint_get( P, End, Raw[i++] ))
+                return false;
+        }
+        return true;
+    }
+}
+
+// --------------------------------------------------------------------------
+
+namespace Perspective
+{
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TimeStreamWriter ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    TimeStreamWriter::TimeStreamWriter( size_t BlockSz, bool DoD )
+        : BlockSize( BlockSz ? BlockSz : 1 ), DeltaOfDelta( DoD )
+    {
+        Bytes.insert( Bytes.end(), _TS_MAGIC, _TS_MAGIC + 3 );
+        Bytes.push_back( _TS_VERSION );
+        Bytes.push_back( DeltaOfDelta ? _TS_FLAG_DOD : 0 );
+        _varint_put( Bytes, BlockSize );
+    }
+
+    void TimeStreamWriter::Append( time_tick_t T )
+    {
+        if (Finished)
+            return;
+        size_t InBlock = size_t( Count % BlockSize );
+        if (InBlock == 0)
+        {
+            Blocks.push_back( Bytes.size() );
+            _varint_put( Bytes, _zigzag_encode( T ) );
+            PrevDelta = 0;
+        }
+        else
+        {
+            time_tick_t Delta = time_tick_t( uint64_t( T ) - uint64_t( Prev ) );  // wraps instead of overflowing
+            _varint_put( Bytes, _zigzag_encode( DeltaOfDelta && InBlock > 1 ? time_tick_t( uint64_t( Delta ) - uint64_t( PrevDelta ) ) : Delta ) );
+            PrevDelta = Delta;
+        }
+        Prev = T;
+        Count++;
+    }
+
+    void TimeStreamWriter::Append( const time_tick_t* Values, size_t N )
+    {
+        for (size_t i = 0; i < N; i++)
+            Append( Values[i] );
+    }
+
+    const std::vector<uint8_t>& TimeStreamWriter::Finish()
+    {
+        if (Finished)
+            return Bytes;
+        uint64_t IndexOffset = Bytes.size();
+        uint64_t Last = 0;
+        _varint_put( Bytes, Blocks.size() );
+        for (uint64_t Offset : Blocks)
+        {
+            _varint_put( Bytes, Offset - Last );
+            Last = Offset;
+        }
+        _put_u64( Bytes, Count );
+        _put_u64( Bytes, IndexOffset );
+        Bytes.insert( Bytes.end(), _TS_TRAILER_MAGIC, _TS_TRAILER_MAGIC + 4 );
+        Finished = true;
+        return Bytes;
+    }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TimeStreamReader ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    bool TimeStreamReader::Open( const uint8_t* Stream, size_t Size )
+    {
+        Data = nullptr;
+        Blocks.clear();
+        Count = 0;
+        if (Size < 6 + _TS_TRAILER || memcmp( Stream, _TS_MAGIC, 3 ) || Stream[3] != _TS_VERSION
+            || memcmp( Stream + Size - 4, _TS_TRAILER_MAGIC, 4 ))
+            return false;
+
+        const uint8_t* P = Stream + 5;
+        const uint8_t* End = Stream + Size - _TS_TRAILER;
+        uint64_t BlockSz, BlocksN;
+        if (!_varint_get( P, End, BlockSz ) || !BlockSz)
+            return false;
+        uint64_t Values = _get_u64( End );
+        uint64_t IndexOffset = _get_u64( End + 8 );
+        if (IndexOffset < uint64_t( P - Stream ) || IndexOffset > uint64_t( End - Stream ))
+            return false;
+
+        // every value takes a byte of the blocks at least, every block - a
+        // byte of the index: hostile counts are rejected before reserving
+        const uint8_t* I = Stream + IndexOffset;
+        if (Values > IndexOffset - uint64_t( P - Stream ))
+            return false;
+        if (!_varint_get( I, End, BlocksN ) || BlocksN > uint64_t( End - I )
+            || BlocksN != Values / BlockSz + (Values % BlockSz ? 1 : 0))
+            return false;
+        uint64_t Offset = 0;
+        Blocks.reserve( size_t( BlocksN ) + 1 );
+        for (uint64_t b = 0; b < BlocksN; b++)
+        {
+            uint64_t Delta;
+            if (!_varint_get( I, End, Delta ))
+                return false;
+            Offset += Delta;
+            if (Offset < uint64_t( P - Stream ) || Offset > IndexOffset || (!Blocks.empty() && Offset < Blocks.back()))
+                return false;
+            Blocks.push_back( Offset );
+        }
+        Blocks.push_back( IndexOffset );
+
+        Data = Stream;
+        DataSize = Size;
+        Count = Values;
+        BlockSize = size_t( BlockSz );
+        DeltaOfDelta = (Stream[4] & _TS_FLAG_DOD) != 0;
+        return true;
+    }
+
+    bool TimeStreamReader::_DecodeBlock( size_t B, size_t Skip, time_tick_t* Out, size_t N ) const
+    {
+        const uint8_t* P = Data + Blocks[B];
+        const uint8_t* End = Data + Blocks[B + 1];
+
+        // skipped values are summed on the fly, so they need no buffer.
+        // Unsigned: wrapping sums are well-defined
+        uint64_t Value = 0, Delta = 0;
+        for (size_t i = 0; i < Skip; i++)
+        {
+            uint64_t u;
+            if (!_varint_get( P, End, u ))
+                return false;
+            u = (u >> 1) ^ (0 - (u & 1));
+            if (i == 0)
+            {
+                Value = u;
+                continue;
+            }
+            Delta = DeltaOfDelta && i >= 2 ? Delta + u : u;
+            Value += Delta;
+        }
+
+        uint64_t* Raw = (uint64_t*)Out;  // decoded in place
+        if (!_varint_run( P, End, Raw, N ))
+            return false;
+
+        // separate passes over a plain array: zigzag, then prefix sums
+        // continuing from the skipped values
+        for (size_t i = 0; i < N; i++)
+            Raw[i] = (Raw[i] >> 1) ^ (0 - (Raw[i] & 1));
+        if (DeltaOfDelta)
+        {
+            if (N && Skip >= 2)
+                Raw[0] += Delta;
+            for (size_t i = Skip ? 1 : 2; i < N; i++)
+                Raw[i] += Raw[i - 1];
+        }
+        if (N && Skip)
+            Raw[0] += Value;
+        for (size_t i = 1; i < N; i++)
+            Raw[i] += Raw[i - 1];
+        return true;
+    }
+
+    size_t TimeStreamReader::Decode( uint64_t First, time_tick_t* Out, size_t N ) const
+    {
+        if (!Data || First >= Count)
+            return 0;
+        if (N > Count - First)
+            N = size_t( Count - First );
+
+        size_t Done = 0;
+        while (Done < N)
+        {
+            uint64_t i = First + Done;
+            size_t B = size_t( i / BlockSize );
+            size_t Skip = size_t( i % BlockSize );
+            size_t InBlock = size_t( std::min<uint64_t>( BlockSize, Count - uint64_t( B ) * BlockSize ) );
+            size_t Take = std::min( InBlock - Skip, N - Done );
+            if (!_DecodeBlock( B, Skip, Out + Done, Take ))  // straight into the output
+                return Done;
+            Done += Take;
+        }
+        return Done;
+    }
+
+    time_tick_t TimeStreamReader::At( uint64_t i ) const
+    {
+        time_tick_t v = 0;
+        Decode( i, &v, 1 );
+        return v;
+    }
+
+}
@@ -0,0 +1,157 @@
+/*
+* Perspective module for compile-time unit-typed durations.
+* Unit is a part of the type, so conversions between units are resolved at
+* compile time into a single integer multiplication or division by constant.
+* Interoperates with Duration: converts to it implicitly and can be
+* constructed from it explicitly.
+* Depends on Perspective::Timer.hpp, <ratio>
+*/
+
+#pragma once
+
+// Standart dependencies: <ratio>, <type_traits>
+#include <ratio>
+#include <type_traits>
+
+// ------------------------- Project dependencies ---------------------------
+#include "Timer.hpp"
+
+namespace Perspective
+{
+// ========================== Conversion helpers ============================
+
+    // scales count by compile-time ratio Factor. Degenerates to a single
+    // multiplication or division by constant if one of ratio parts is 1
+    template<class ToRep, class Factor, class FromRep>
+    constexpr ToRep _scale_count( const FromRep& v )
+    {
+        typedef typename std::common_type<ToRep, FromRep, time_int64_t>::type CommonT;
+        return Factor::num == 1 && Factor::den == 1 ? ToRep( v )
+            : Factor::den == 1 ? ToRep( CommonT( v ) * CommonT( Factor::num ) )
+            : Factor::num == 1 ? ToRep( CommonT( v ) / CommonT( Factor::den ) )
+            : ToRep( CommonT( v ) * CommonT( Factor::num ) / CommonT( Factor::den ) );
+    }
+
+#ifdef PER_TIME_WINDOWS_QPC
+    // tick rate is known only at runtime: a single division remains
+    template<class ToRep, class Period>
+    inline ToRep _ticks_to_count( const time_tick_t& t )
+    {
+        typedef typename std::common_type<ToRep, time_int64_t>::type CommonT;
+        return ToRep( CommonT( t ) * CommonT( Period::den ) / (CommonT( TICKS_PER_SEC ) * CommonT( Period::num )) );
+    }
+
+    template<class Period, class FromRep>
+    inline time_tick_t _count_to_ticks( const FromRep& v )
+    {
+        typedef typename std::common_type<FromRep, time_int64_t>::type CommonT;
+        return time_tick_t( CommonT( v ) * CommonT( TICKS_PER_SEC ) * CommonT( Period::num ) / CommonT( Period::den ) );
+    }
+#else
+    template<class ToRep, class Period>
+    constexpr ToRep _ticks_to_count( const time_tick_t& t )
+    {
+        return _scale_count<ToRep, std::ratio_divide<time_tick_period, Period>>( t );
+    }
+
+    template<class Period, class FromRep>
+    constexpr time_tick_t _count_to_ticks( const FromRep& v )
+    {
+        return _scale_count<time_tick_t, std::ratio_divide<Period, time_tick_period>>( v );
+    }
+#endif
+
+// ============================ UnitDuration ================================
+
+    // Class UnitDuration - time interval with unit encoded in the type. Rep
+    // is a storage type (integral or real), TickRatio is a length of a single
+    // unit in seconds as std::ratio. Trivially copyable and constexpr.
+    // Lossless unit changes are implicit, lossy ones require unit_cast.
+    template<class Rep, class TickRatio>
+    class UnitDuration
+    {
+    protected:
+        Rep count_;  // amount of units
+
+        // true if conversion from OtherRatio units never loses precision
+        template<class OtherRep, class OtherRatio>
+        using _is_exact = std::integral_constant<bool,
+            std::is_floating_point<Rep>::value ||
+            (std::ratio_divide<OtherRatio, TickRatio>::den == 1 && !std::is_floating_point<OtherRep>::value)>;
+
+    public:
+        typedef Rep rep;  // storage type
+        typedef TickRatio period;  // unit length in seconds
+
+// -------------------------- Methods --------------------------------------
+
+        constexpr UnitDuration() : count_( 0 ) {}  // zero-length interval
+        constexpr explicit UnitDuration( const Rep& v ) : count_( v ) {}  // main constructor - amount of units
+
+        // implicit lossless conversion from other units
+        template<class OtherRep, class OtherRatio,
+            class = typename std::enable_if<_is_exact<OtherRep, OtherRatio>::value>::type>
+        constexpr UnitDuration( const UnitDuration<OtherRep, OtherRatio>& dt )
+            : count_( _scale_count<Rep, std::ratio_divide<OtherRatio, TickRatio>>( dt.count() ) ) {}
+
+        // explicit conversion from tick-based Duration (truncates towards zero)
+        PER_TIME_TICKS_CONSTEXPR explicit UnitDuration( const Duration& dt )
+            : count_( _ticks_to_count<Rep, TickRatio>( dt.getTicks() ) ) {}
+
+        // implicit conversion to tick-based Duration, so Timer, Expectant,
+        // Repeater and others accept unit-typed intervals as is
+        PER_TIME_TICKS_CONSTEXPR operator Duration() const { return Duration( _count_to_ticks<TickRatio>( count_ ) ); }
+
+        constexpr Rep count() const { return count_; }  // amount of units
+
+// ------------------------ Time algebra ------------------------------------
+
+        inline UnitDuration& operator+= ( const UnitDuration& dt ) { count_ += dt.count_; return *this; }
+        inline UnitDuration& operator-= ( const UnitDuration& dt ) { count_ -= dt.count_; return *this; }
+        inline UnitDuration& operator*= ( const Rep& v ) { count_ *= v; return *this; }
+        inline UnitDuration& operator/= ( const Rep& v ) { count_ /= v; return *this; }
+
+        constexpr UnitDuration operator+ ( const UnitDuration& dt ) const { return UnitDuration( count_ + dt.count_ ); }
+        constexpr UnitDuration operator- ( const UnitDuration& dt ) const { return UnitDuration( count_ - dt.count_ ); }
+        constexpr UnitDuration operator- () const { return UnitDuration( -count_ ); }
+        constexpr UnitDuration operator* ( const Rep& v ) const { return UnitDuration( count_ * v ); }
+        constexpr UnitDuration operator/ ( const Rep& v ) const { return UnitDuration( count_ / v ); }
+        constexpr Rep operator/ ( const UnitDuration& dt ) const { return count_ / dt.count_; }
+        constexpr UnitDuration operator% ( const UnitDuration& dt ) const { return UnitDuration( count_ % dt.count_ ); }
+
+// --------------------------- Comparisons ----------------------------------
+
+        constexpr bool operator== ( const UnitDuration& dt ) const { return count_ == dt.count_; }
+        constexpr bool operator!= ( const UnitDuration& dt ) const { return count_ != dt.count_; }
+        constexpr bool operator> ( const UnitDuration& dt ) const { return count_ > dt.count_; }
+        constexpr bool operator< ( const UnitDuration& dt ) const { return count_ < dt.count_; }
+        constexpr bool operator>= ( const UnitDuration& dt ) const { return count_ >= dt.count_; }
+        constexpr bool operator<= ( const UnitDuration& dt ) const { return count_ <= dt.count_; }
+    };
+
+// ~~~~~~~~~~~~~~~~~~ UnitDuration External functionality ~~~~~~~~~~~~~~~~~~
+
+    // explicit (possibly lossy) conversion between units. Truncates towards zero
+    template<class To, class Rep, class TickRatio>
+    constexpr To unit_cast( const UnitDuration<Rep, TickRatio>& dt )
+    {
+        return To( _scale_count<typename To::rep, std::ratio_divide<TickRatio, typename To::period>>( dt.count() ) );
+    }
+
+    // explicit conversion from tick-based Duration. Truncates towards zero
+    template<class To>
+    PER_TIME_TICKS_CONSTEXPR To unit_cast( const Duration& dt ) { return To( dt ); }
+
+    // common units
+    typedef UnitDuration<time_int64_t, std::nano> NanoSec;
+    typedef UnitDuration<time_int64_t, std::micro> MicroSec;
+    typedef UnitDuration<time_int64_t, std::milli> MilliSec;
+    typedef UnitDuration<time_int64_t, std::ratio<1>> Sec;
+    typedef UnitDuration<time_real_t, std::milli> RealMilliSec;
+    typedef UnitDuration<time_real_t, std::ratio<1>> RealSec;
+#ifndef PER_TIME_WINDOWS_QPC
+    typedef UnitDuration<time_tick_t, time_tick_period> Ticks;  // native ticks
+#endif
+
+    static_assert( std::is_trivially_copyable<MicroSec>::value, "UnitDuration must stay trivially copyable" );
+}
@@ -1,32 +1,75 @@
 /* TimeUtils Realizations
- * Depends on Perspective::Timer.hpp, <chrono>, <thread>
+ * Depends on Perspective::Timer.hpp, <chrono>, <thread>, <algorithm>
  */
 
 #include "TimeUtils.hpp"
 
-// Standart dependencies: <thread>
+// Standart dependencies: <thread>, <algorithm>
 #include <thread>  // std::this_tread::sleep_for
+#include <algorithm>  // BudgetScheduler progress lookups
+
+#if defined(__linux__) && !defined(PER_TIME_WINDOWS_QPC)
+#include <errno.h>  // clock_nanosleep interruptions
+#define PER_TIME_ABS_NANOSLEEP  // steady ticks and CLOCK_MONOTONIC share epoch
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>  // _mm_pause
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>  // address waits
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#define PER_TIME_FUTEX
+#elif defined(_WIN32)
+#include <Windows.h>  // WaitOnAddress, Windows 8+
+#pragma comment( lib, "Synchronization.lib" )
+#define PER_TIME_WAIT_ON_ADDRESS
+#endif
 
 // ----------------------- Local utility functions --------------------------
 
+// relative sleep with full tick precision
 inline void _Sleep( const Perspective::Duration& Dur )
 {
+    if (Dur <= Perspective::ZERO_Duration)
+        return;
+    std::this_thread::sleep_for( std::chrono::nanoseconds( Perspective::NanoSec( Dur ).count() ) );
+}
 
-// seems like this attempt does not work
-//#if _TPS >= 1000000
-//    std::cout<<"--1000000"<<std::endl;
-//    std::this_thread::sleep_for( std::chrono::microseconds( Dur.asMicroSecInt() ) );
-//#elif _TPS >= 1000
-//    std::cout<<"--1000"<<std::endl;
-//    std::this_thread::sleep_for( std::chrono::milliseconds( Dur.asMilliSecInt() ) );
-//#else
-//    //std::cout<<"--1"<<std::endl;
-//    std::this_thread::sleep_for( std::chrono::seconds( Dur.asSecInt() ) );
-//#endif
-
-    // simple and nice
-    std::this_thread::sleep_for( std::chrono::milliseconds( Dur.asMilliSecInt() ) );
+// absolute sleep until a moment of system time
+inline void _SleepUntil( const Perspective::Time& Tm )
+{
+#if defined(PER_TIME_ABS_NANOSLEEP)
+    timespec Ts;
+    Ts.tv_sec = time_t( Tm.getTicks() / Perspective::TICKS_PER_SEC );
+    Ts.tv_nsec = long( Tm.getTicks() % Perspective::TICKS_PER_SEC * 1000000000 / Perspective::TICKS_PER_SEC );
+    while (clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &Ts, nullptr ) == EINTR);
+#elif defined(PER_TIME_WINDOWS_QPC)
+    _Sleep( Tm - Perspective::SystemTime() );
+#else
+    std::this_thread::sleep_until( std::chrono::steady_clock::time_point( std::chrono::steady_clock::duration( Tm.getTicks() ) ) );
+#endif
+}
 
+// polite busy-wait iteration
+inline void _SpinPause()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#endif
+}
+
+// spin threshold of precise sleeps, 0 - default 1 ms. Resolved on use: with
+// QPC TICKS_PER_SEC is set at runtime and may be 0 during static init
+static std::atomic<Perspective::time_tick_t> _SpinThreshold{ 0 };
+
+inline Perspective::Duration _GetSpinThreshold()
+{
+    Perspective::time_tick_t Ticks = _SpinThreshold.load( std::memory_order_relaxed );
+    return Perspective::Duration( Ticks ? Ticks : Perspective::TICKS_PER_SEC / 1000 );
 }
 
 // --------------------------------------------------------------------------
@@ -34,10 +77,522 @@ inline void _Sleep( const Perspective::Duration& Dur )
 namespace Perspective
 {
 
-    void Sleep( const Duration& Dur ) { _Sleep( Dur ); }
+    void Sleep( const Duration& Dur )
+    {
+        if (TimeSource* Source = GetTimeSource())
+            return Source->WaitUntil( Source->Now() + Dur );
+        _Sleep( Dur );
+    }
+
+    void SleepUntil( const Duration& Dur )
+    {
+        if (TimeSource* Source = GetTimeSource())
+            return Source->WaitUntil( Dur );
+        _SleepUntil( Time() + Dur );
+    }
+
+    void SleepUntil( const Time& Tm ) { SleepUntil( Tm - Time() ); }
+
+// ----------------------------- Precise sleep ------------------------------
+
+    void PreciseSleep( const Duration& Dur ) { PreciseSleepUntil( ProgramTime() + Dur ); }
+
+    void PreciseSleepUntil( const Time& Tm ) { PreciseSleepUntil( Tm - Time() ); }
+
+    void PreciseSleepUntil( const Duration& Dur )
+    {
+        if (TimeSource* Source = GetTimeSource())
+            return Source->WaitUntil( Dur );
+        Duration Threshold = _GetSpinThreshold();
+        if (Dur - ProgramTime() > Threshold)
+            _SleepUntil( Time() + (Dur - Threshold) );
+        while (ProgramTime() < Dur)
+            _SpinPause();
+    }
+
+    void SetSleepSpinThreshold( const Duration& Dur )
+    {
+        _SpinThreshold.store( Dur.getTicks() > 0 ? Dur.getTicks() : 1, std::memory_order_relaxed );  // 0 is reserved for the default
+    }
+
+    Duration GetSleepSpinThreshold() { return _GetSpinThreshold(); }
+
+    Duration CalibrateSleepSpinThreshold( int Samples )
+    {
+        if (GetTimeSource())  // OS wake-up latency can't be measured on a replaced clock
+            return GetSleepSpinThreshold();
+        const Duration Request = microsec( 500 );
+        Duration Worst = ZERO_Duration;
+        for (int i = 0; i < Samples; i++)
+        {
+            Duration Target = ProgramTime() + Request;
+            _SleepUntil( Time() + Target );
+            Duration Late = ProgramTime() - Target;
+            if (Late > Worst)
+                Worst = Late;
+        }
+        Duration Threshold = Worst + Worst / 4. + microsec( 20 );  // margin for rare worse wake-ups
+        SetSleepSpinThreshold( Threshold );
+        return Threshold;
+    }
+
+// ----------------------------- Time sources -------------------------------
+
+    void ManualClock::WaitUntil( const Duration& Deadline )
+    {
+        std::unique_lock<std::mutex> Lock( Guard );
+        Moved.wait( Lock, [&] { return Ticks.load( std::memory_order_acquire ) >= Deadline.getTicks(); } );
+    }
+
+    void ManualClock::Advance( const Duration& dt )
+    {
+        if (dt <= ZERO_Duration)
+            return;
+        {
+            std::lock_guard<std::mutex> Lock( Guard );
+            Ticks.fetch_add( dt.getTicks(), std::memory_order_acq_rel );
+        }
+        Moved.notify_all();
+    }
+
+    void ManualClock::Set( const Duration& T )
+    {
+        {
+            std::lock_guard<std::mutex> Lock( Guard );
+            if (T.getTicks() <= Ticks.load( std::memory_order_relaxed ))
+                return;
+            Ticks.store( T.getTicks(), std::memory_order_release );
+        }
+        Moved.notify_all();
+    }
+
+// --------------------------- Periodic Sleeper -----------------------------
+
+    bool PeriodicSleeper::Wait()
+    {
+        Duration Now = ProgramTime();
+        if (Now >= Next)
+        {
+            // missed: skip to the first deadline in the future
+            time_tick_t Missed = (Now - Next).getTicks() / Period.getTicks() + 1;
+            Overruns += Missed;
+            Lateness = Now - Next;
+            Next += Duration( Missed * Period.getTicks() );
+            return false;
+        }
+
+        if (Precise)
+            PreciseSleepUntil( Next );
+        else
+            SleepUntil( Next );
+
+        Lateness = ProgramTime() - Next;
+        Next += Period;
+        return true;
+    }
+
+// ----------------------------- Timing Wheel -------------------------------
+
+    TimingWheel::TimingWheel( const Duration& Gran, const Duration& Start )
+        : Origin( Start ), Granularity( Gran.getTicks() > 0 ? Gran : SMALLEST_Duration )
+    {
+        for (uint32_t i = 0; i < LEVELS * SLOTS; i++)
+            Heads[i] = NIL;
+    }
+
+    void TimingWheel::Reserve( size_t Count )
+    {
+        Pool.reserve( Count );
+        Batch.reserve( Count );
+    }
+
+    uint64_t TimingWheel::ToTick( const Duration& Moment ) const
+    {
+        time_tick_t Rel = (Moment - Origin).getTicks();
+        if (Rel <= 0)
+            return 0;
+        return uint64_t( (Rel + Granularity.getTicks() - 1) / Granularity.getTicks() );
+    }
+
+    // level is chosen by distance to the deadline, slot - by deadline bits
+    // of that level, so a slot is reached exactly when its level wraps
+    void TimingWheel::Link( uint32_t Index )
+    {
+        Entry& E = Pool[Index];
+        uint64_t Deadline = E.Deadline < Current ? Current : E.Deadline;
+        uint64_t Delta = Deadline - Current;
+        const uint64_t Range = (uint64_t)1 << (SLOT_BITS * LEVELS);
+        if (Delta >= Range)  // beyond the wheel: park in the farthest slot, re-cascaded later
+        {
+            Delta = Range - 1;
+            Deadline = Current + Delta;
+        }
+
+        int Level = 0;
+        while (Delta >= ((uint64_t)1 << (SLOT_BITS * (Level + 1))))
+            Level++;
+        uint32_t Slot = Level * SLOTS + uint32_t( (Deadline >> (SLOT_BITS * Level)) & SLOT_MASK );
+
+        E.Slot = Slot;
+        E.Prev = NIL;
+        E.Next = Heads[Slot];
+        if (E.Next != NIL)
+            Pool[E.Next].Prev = Index;
+        Heads[Slot] = Index;
+    }
+
+    void TimingWheel::Unlink( uint32_t Index )
+    {
+        Entry& E = Pool[Index];
+        if (E.Prev != NIL)
+            Pool[E.Prev].Next = E.Next;
+        else
+            Heads[E.Slot] = E.Next;
+        if (E.Next != NIL)
+            Pool[E.Next].Prev = E.Prev;
+        E.Slot = NIL;
+    }
+
+    void TimingWheel::Cascade( int Level, uint32_t Slot )
+    {
+        uint32_t Index = Heads[Level * SLOTS + Slot];
+        Heads[Level * SLOTS + Slot] = NIL;
+        while (Index != NIL)
+        {
+            uint32_t Next = Pool[Index].Next;
+            Link( Index );
+            Index = Next;
+        }
+    }
+
+    TimingWheel::TimerId TimingWheel::Insert( uint64_t Deadline, uint64_t Period, uint64_t UserData )
+    {
+        uint32_t Index;
+        if (FreeHead != NIL)
+        {
+            Index = FreeHead;
+            FreeHead = Pool[Index].Next;
+        }
+        else
+        {
+            Index = uint32_t( Pool.size() );
+            Pool.push_back( Entry{ 0, 0, 0, NIL, NIL, NIL, 0 } );
+        }
+
+        Entry& E = Pool[Index];
+        E.Deadline = Deadline;
+        E.Period = Period;
+        E.UserData = UserData;
+        Link( Index );
+        Active++;
+        return ((TimerId)E.Gen << 32) | Index;
+    }
+
+    TimingWheel::TimerId TimingWheel::ScheduleAt( const Duration& Deadline, uint64_t UserData )
+    {
+        return Insert( ToTick( Deadline ), 0, UserData );
+    }
+
+    TimingWheel::TimerId TimingWheel::SchedulePeriodicAt( const Duration& First, const Duration& Period, uint64_t UserData )
+    {
+        uint64_t Ticks = ToTick( Origin + Period );
+        return Insert( ToTick( First ), Ticks ? Ticks : 1, UserData );
+    }
+
+    bool TimingWheel::IsScheduled( TimerId Id ) const
+    {
+        uint32_t Index = uint32_t( Id );
+        return Index < Pool.size() && Pool[Index].Gen == uint32_t( Id >> 32 ) && Pool[Index].Slot != NIL;
+    }
+
+    bool TimingWheel::Cancel( TimerId Id )
+    {
+        if (!IsScheduled( Id ))
+            return false;
+        uint32_t Index = uint32_t( Id );
+        Unlink( Index );
+        Pool[Index].Gen++;  // invalidates the id
+        Pool[Index].Next = FreeHead;
+        FreeHead = Index;
+        Active--;
+        return true;
+    }
+
+    const std::vector<TimingWheel::Expired>& TimingWheel::Advance( const Duration& Now )
+    {
+        Batch.clear();
+        // tick T is due when Now reaches its beginning
+        time_tick_t Rel = (Now - Origin).getTicks();
+        if (Rel < 0)
+            return Batch;
+        uint64_t Target = uint64_t( Rel / Granularity.getTicks() );
+
+        while (Current <= Target)
+        {
+            if (!Active)
+            {
+                Current = Target + 1;  // nothing to expire - jump
+                break;
+            }
+
+            uint32_t Slot = uint32_t( Current & SLOT_MASK );
+            for (int Level = 1; Level < LEVELS && !Slot; Level++)
+            {
+                Slot = uint32_t( (Current >> (SLOT_BITS * Level)) & SLOT_MASK );
+                Cascade( Level, Slot );
+            }
+
+            uint32_t Index = Heads[Current & SLOT_MASK];
+            Heads[Current & SLOT_MASK] = NIL;
+            Current++;
+            while (Index != NIL)
+            {
+                Entry& E = Pool[Index];
+                uint32_t Next = E.Next;
+                Batch.push_back( Expired{ ((TimerId)E.Gen << 32) | Index, E.UserData } );
+                if (E.Period)
+                {
+                    // next period from the deadline; periods missed by a late Advance() are skipped
+                    E.Deadline += E.Period;
+                    if (E.Deadline < Current)
+                        E.Deadline += (Current - E.Deadline + E.Period - 1) / E.Period * E.Period;
+                    Link( Index );
+                }
+                else
+                {
+                    E.Slot = NIL;
+                    E.Gen++;
+                    E.Next = FreeHead;
+                    FreeHead = Index;
+                    Active--;
+                }
+                Index = Next;
+            }
+        }
+        return Batch;
+    }
+
+// --------------------------- Budget Scheduler -----------------------------
+
+    BudgetScheduler::TaskId BudgetScheduler::Submit( WorkItem Work )
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        TaskId Id = NextId++;
+        Submitted.push_back( Task{ Id, std::move( Work ), 0.f } );
+        Progress.emplace_back( Id, 0.f );  // ids grow: stays sorted
+        return Id;
+    }
+
+    bool BudgetScheduler::Cancel( TaskId Id )
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        auto It = std::lower_bound( Progress.begin(), Progress.end(), std::make_pair( Id, -1.f ) );
+        if (It == Progress.end() || It->first != Id)
+            return false;
+        Progress.erase( It );
+        Canceled.push_back( Id );
+        return true;
+    }
+
+    size_t BudgetScheduler::Run( const Duration& Budget )
+    {
+        ElementaryTimer Clock;
+        {
+            std::lock_guard<std::mutex> Lock( Guard );
+            for (Task& T : Submitted)
+                Tasks.push_back( std::move( T ) );
+            Submitted.clear();
+            for (TaskId Id : Canceled)
+                for (size_t i = 0; i < Tasks.size(); i++)
+                    if (Tasks[i].Id == Id)
+                    {
+                        Tasks.erase( Tasks.begin() + i );
+                        if (Cursor > i)
+                            Cursor--;
+                        break;
+                    }
+            Canceled.clear();
+        }
+
+        std::vector<TaskId> Finished;
+        Slice S( Clock, Budget, 0.f );
+        size_t Idle = 0;  // items in a row that reported no progress
+        while (!Tasks.empty() && !S.Expired() && Idle < Tasks.size())
+        {
+            if (Cursor >= Tasks.size())
+                Cursor = 0;
+            Task& T = Tasks[Cursor];
+            S.Progress = T.Progress;
+            S.Stalled = false;
+            if (T.Work( S ))
+            {
+                Finished.push_back( T.Id );
+                Tasks.erase( Tasks.begin() + Cursor );  // next item moves into Cursor
+                Idle = 0;
+            }
+            else
+            {
+                T.Progress = S.Progress;
+                Idle = S.Stalled ? Idle + 1 : 0;
+                Cursor++;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock( Guard );
+            for (TaskId Id : Finished)
+            {
+                auto It = std::lower_bound( Progress.begin(), Progress.end(), std::make_pair( Id, -1.f ) );
+                if (It != Progress.end() && It->first == Id)
+                    Progress.erase( It );
+            }
+            for (const Task& T : Tasks)
+            {
+                auto It = std::lower_bound( Progress.begin(), Progress.end(), std::make_pair( T.Id, -1.f ) );
+                if (It != Progress.end() && It->first == T.Id)
+                    It->second = T.Progress;
+            }
+        }
+        LastUsed = Clock.GetTime();
+        return Finished.size();
+    }
+
+    bool BudgetScheduler::IsPending( TaskId Id ) const
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        auto It = std::lower_bound( Progress.begin(), Progress.end(), std::make_pair( Id, -1.f ) );
+        return It != Progress.end() && It->first == Id;
+    }
+
+    float BudgetScheduler::GetProgress( TaskId Id ) const
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        auto It = std::lower_bound( Progress.begin(), Progress.end(), std::make_pair( Id, -1.f ) );
+        return It != Progress.end() && It->first == Id ? It->second : 1.f;
+    }
+
+    size_t BudgetScheduler::Size() const
+    {
+        std::lock_guard<std::mutex> Lock( Guard );
+        return Progress.size();
+    }
+
+// --------------------------- Address wait/wake ----------------------------
+
+    static_assert( sizeof( std::atomic<uint32_t> ) == sizeof( uint32_t ), "address waits need plain 32-bit atomics" );
+
+    bool _AddressWait( std::atomic<uint32_t>& Addr, uint32_t Expected, const Duration& Deadline )
+    {
+        bool Infinite = Deadline == MAX_Duration;
+        TimeSource* Source = GetTimeSource();
+        Duration Now = ProgramTime();
+        if (!Infinite && Now >= Deadline)
+            return false;
+#if defined(PER_TIME_FUTEX)
+        // absolute CLOCK_MONOTONIC deadline: steady ticks share its epoch. A
+        // replaced clock gives only the remaining interval
+        timespec Ts, *PTs = nullptr;
+        if (!Infinite)
+        {
+            time_tick_t Abs = Source ? std::chrono::steady_clock::now().time_since_epoch().count() + (Deadline - Now).getTicks()
+                : (Time() + Deadline).getTicks();
+            Ts.tv_sec = time_t( Abs / TICKS_PER_SEC );
+            Ts.tv_nsec = long( Abs % TICKS_PER_SEC * 1000000000 / TICKS_PER_SEC );
+            PTs = &Ts;
+        }
+        long R = syscall( SYS_futex, (uint32_t*)&Addr, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, Expected, PTs, nullptr, FUTEX_BITSET_MATCH_ANY );
+        return !(R == -1 && errno == ETIMEDOUT);
+#elif defined(PER_TIME_WAIT_ON_ADDRESS)
+        (void)Source;
+        DWORD Ms = Infinite ? INFINITE : DWORD( (Deadline - Now).getTicks() / TICKS_PER_MSEC + 1 );  // rounded up: never early
+        if (WaitOnAddress( &Addr, &Expected, sizeof( Expected ), Ms ))
+            return true;
+        return GetLastError() != ERROR_TIMEOUT;
+#else
+        (void)Source;
+        if (Addr.load( std::memory_order_acquire ) != Expected)
+            return true;
+        Duration Step = microsec( 50 );  // no address waits: short sleeps
+        _Sleep( Infinite || Deadline - Now > Step ? Step : Deadline - Now );
+        return Infinite || ProgramTime() < Deadline;
+#endif
+    }
+
+    void _AddressWake( std::atomic<uint32_t>& Addr, bool All )
+    {
+#if defined(PER_TIME_FUTEX)
+        syscall( SYS_futex, (uint32_t*)&Addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, All ? INT32_MAX : 1, nullptr, nullptr, 0 );
+#elif defined(PER_TIME_WAIT_ON_ADDRESS)
+        if (All)
+            WakeByAddressAll( &Addr );
+        else
+            WakeByAddressSingle( &Addr );
+#else
+        (void)Addr;
+        (void)All;
+#endif
+    }
+
+// ------------------------------ Timed Event -------------------------------
+
+    void TimedEvent::Set()
+    {
+        State.store( 1, std::memory_order_seq_cst );  // pairs with Waiters increment of WaitUntil
+        if (Waiters.load( std::memory_order_seq_cst ))
+            _AddressWake( State, !AutoReset );
+    }
+
+    bool TimedEvent::TryWait()
+    {
+        if (!AutoReset)
+            return State.load( std::memory_order_acquire ) != 0;
+        return State.exchange( 0, std::memory_order_acq_rel ) != 0;
+    }
+
+    bool TimedEvent::WaitUntil( const Duration& Deadline )
+    {
+        for (;;)
+        {
+            if (TryWait())
+                return true;
+            Waiters.fetch_add( 1, std::memory_order_seq_cst );
+            bool InTime = _AddressWait( State, 0, Deadline );  // sleeps only while not signaled
+            Waiters.fetch_sub( 1, std::memory_order_relaxed );
+            if (!InTime)
+                return TryWait();  // last chance: signaled right at the deadline
+        }
+    }
+
+// ---------------------------- Timed Semaphore -----------------------------
+
+    void TimedSemaphore::Release( uint32_t N )
+    {
+        Count.fetch_add( N, std::memory_order_seq_cst );  // pairs with Waiters increment of AcquireUntil
+        if (Waiters.load( std::memory_order_seq_cst ))
+            _AddressWake( Count, N > 1 );
+    }
 
-    void SleepUntil( const Duration& Dur ) { _Sleep ( Dur - ProgramTime() ); }
+    bool TimedSemaphore::TryAcquire()
+    {
+        uint32_t C = Count.load( std::memory_order_relaxed );
+        while (C)
+            if (Count.compare_exchange_weak( C, C - 1, std::memory_order_acquire, std::memory_order_relaxed ))
+                return true;
+        return false;
+    }
 
-    void SleepUntil( const Time& Tm ) { _Sleep ( Tm - SystemTime() ); }
+    bool TimedSemaphore::AcquireUntil( const Duration& Deadline )
+    {
+        for (;;)
+        {
+            if (TryAcquire())
+                return true;
+            Waiters.fetch_add( 1, std::memory_order_seq_cst );
+            bool InTime = _AddressWait( Count, 0, Deadline );  // sleeps only while Count is still 0
+            Waiters.fetch_sub( 1, std::memory_order_relaxed );
+            if (!InTime)
+                return TryAcquire();
+        }
+    }
 
 }
@@ -1,12 +1,21 @@
 /*
 * Perspective module for speed-up development of advanced time functionality.
-* Depends on Perspective::Timer.hpp
+* Depends on Perspective::Timer.hpp, Perspective::TimeUnits.hpp
 */
 
 #pragma once
 
 // ------------------------- Project dependencies ---------------------------
 #include "Timer.hpp"
+#include "TimeUnits.hpp"  // unit-typed durations convert to Duration implicitly
+
+// Standart dependencies: <atomic>, <vector>, <mutex>, <condition_variable>, <functional>, <cmath>
+#include <atomic>  // ConcurrentTimer seqlock
+#include <vector>  // TimingWheel pools
+#include <mutex>  // ManualClock sleepers, BudgetScheduler submissions
+#include <condition_variable>
+#include <functional>  // BudgetScheduler work items
+#include <cmath>  // RateLimiter rate checks
 
 // deprecated
 //const Perspective::time_tick_t _TPS = Perspective::TICKS_PER_SEC;
@@ -16,38 +25,120 @@ namespace Perspective
 // ========================== External functions ============================
 
     // make current thread inactive for a given duration. Has OS-dependent 
-    // precision. Based on std::thread, so have to be std::thread-compatible.
-    // Should not consume any CPU power.
+    // precision (no truncation to milliseconds). Based on std::thread, so
+    // have to be std::thread-compatible. Should not consume any CPU power.
     void Sleep(const Duration& Dur);
 
     // make current thread inactive until a given time point (or duration since
-    // program start). Has OS-dependent precision. Based on std::thread, so 
-    // have to be std::thread-compatible. Should not consume any CPU power.
+    // program start). Deadline is absolute (clock_nanosleep with TIMER_ABSTIME
+    // where available), so periodic loops don't accumulate drift. Has
+    // OS-dependent precision. Should not consume any CPU power.
+    // All sleeps wait on the installed TimeSource instead of the OS, if any.
     void SleepUntil(const Duration& Dur);
     void SleepUntil(const Time& Tm);
 
+    // hybrid precise sleep: sleeps in kernel until the spin threshold before
+    // the deadline and spin-waits the remainder on ProgramTime(). Accurate to
+    // the clock precision at the cost of up to one threshold of CPU time
+    void PreciseSleep(const Duration& Dur);
+    void PreciseSleepUntil(const Duration& Dur);
+    void PreciseSleepUntil(const Time& Tm);
+
+    // spin threshold of precise sleeps. Should cover the usual OS wake-up
+    // latency: larger wastes CPU, smaller lets kernel oversleep the deadline.
+    // 1 ms by default, non-positive values are clamped to the smallest tick
+    void SetSleepSpinThreshold(const Duration& Dur);
+    Duration GetSleepSpinThreshold();
+
+    // measures OS wake-up latency of several short sleeps and sets the spin
+    // threshold to cover the worst of them with a margin. Returns new threshold
+    Duration CalibrateSleepSpinThreshold(int Samples = 20);
+
+// ============================= Time sources ===============================
+
+    // Time source which moves only when told to: Advance() or Set(). Sleeps of
+    // other threads block until the clock is moved past their deadlines. Never
+    // moves backwards. For tests which step time explicitly
+    class ManualClock : public TimeSource
+    {
+    protected:
+        std::atomic<time_tick_t> Ticks;  // current time since program start
+        std::mutex Guard;  // protects sleepers from missed wake-ups
+        std::condition_variable Moved;
+    public:
+        explicit ManualClock( const Duration& Start = ProgramTime() ) : Ticks( Start.getTicks() ) {}  // continues from now by default
+
+        Duration Now() const override { return Duration( Ticks.load( std::memory_order_acquire ) ); }
+        void WaitUntil( const Duration& Deadline ) override;  // blocks until moved past Deadline
+
+        void Advance( const Duration& dt );  // moves the clock forward by dt, wakes sleepers
+        void Set( const Duration& T );  // moves the clock to T if it is later than now, wakes sleepers
+    };
+
+    // Discrete-event time source: a sleep moves the clock to its deadline at
+    // once instead of waiting, so timers, Repeaters and FixedStepLoop run as
+    // fast as the CPU allows - an hour of game time in seconds
+    class VirtualClock : public ManualClock
+    {
+    public:
+        explicit VirtualClock( const Duration& Start = ProgramTime() ) : ManualClock( Start ) {}
+
+        void WaitUntil( const Duration& Deadline ) override { Set( Deadline ); }
+    };
+
+    // installs time source for the lifetime of the object, then restores previous one
+    class ScopedTimeSource
+    {
+    protected:
+        TimeSource* Previous;
+    public:
+        explicit ScopedTimeSource( TimeSource& Source ) : Previous( SetTimeSource( &Source ) ) {}
+        ~ScopedTimeSource() { SetTimeSource( Previous ); }
+
+        ScopedTimeSource( const ScopedTimeSource& ) = delete;
+        ScopedTimeSource& operator= ( const ScopedTimeSource& ) = delete;
+    };
+
+// ========================== Address wait/wake =============================
+
+    // Futex-like primitives on a 32-bit word: futex on Linux, WaitOnAddress on
+    // Windows, short sleeps elsewhere. _AddressWait blocks while Addr holds
+    // Expected, until woken or the Deadline (duration since program start,
+    // MAX_Duration - no deadline). Spurious returns are possible. Returns
+    // false only on timeout. Building blocks of TimedEvent and TimedSemaphore
+    bool _AddressWait( std::atomic<uint32_t>& Addr, uint32_t Expected, const Duration& Deadline );
+    void _AddressWake( std::atomic<uint32_t>& Addr, bool All );
+
 // ============================ Utility classes =============================
 
 // ---------------------------- Elementary Timer ----------------------------
 
-    // the most simple timer based on ProgramTime(). Has no virtual members. 
-    // Has size equal to single Duration instance. Made for extreamly fast 
-    // time requests.
-    class ElementaryTimer
+    // the most simple timer based on a clock source (ProgramTime() by default).
+    // Has no virtual members. Has size equal to single Duration instance. Made
+    // for extreamly fast time requests.
+    template<class ClockT = ProgramClock>
+    class BasicElementaryTimer
     {
     protected:
-        Duration StartT = ProgramTime();  // simply start time - time interval since program start
+        Duration StartT = ClockT::now();  // simply start time - time interval since program start
     public:
-        inline const Duration& GetTime() const { return ProgramTime() - StartT; }  // returns time since timer has started. Has inner subtraction operation
+        typedef ClockT clock_type;  // clock source of the timer
+
+        inline Duration GetTime() const { return ClockT::now() - StartT; }  // returns time since timer has started. Has inner subtraction operation
         inline const Duration& GetStart() const { return StartT; }  // simply returns current start time
-        inline void Reset() { StartT = ProgramTime(); }  // resets timer start time to current program time
+        inline void Reset() { StartT = ClockT::now(); }  // resets timer start time to current clock time
     };
 
+    typedef BasicElementaryTimer<ProgramClock> ElementaryTimer;  // precise elementary timer
+    typedef BasicElementaryTimer<CoarseProgramClock> CoarseElementaryTimer;  // single-load elementary timer
+    typedef BasicElementaryTimer<FrameClock> FrameElementaryTimer;  // reads the frame snapshot
+
 // ------------------------------- Expectant --------------------------------
 
     // simple template class. Provides functionality for awaiting for either 
-    // a duration or a point of time calculated by specific timer.
-    template<class TimerType = Timer>
+    // a duration or a point of time calculated by specific timer. ClockT is
+    // a clock source for "since now" requests.
+    template<class TimerType = Timer, class ClockT = ProgramClock>
     class Expectant
     {
     protected:
@@ -56,7 +147,7 @@ namespace Perspective
     public:
         Expectant( TimerType* PT ) : PTimer( PT ) {}  // simple and only constructor for setting the timer pointer
 
-        inline void waitFor( const Duration& Dur ) { Expected = Dur + ProgramTime(); }  // begin awaiting for a duration since now
+        inline void waitFor( const Duration& Dur ) { Expected = Dur + ClockT::now(); }  // begin awaiting for a duration since now
         inline void waitUntil( const Duration& Dur ) { Expected = Dur; }  // begin awaiting for a specific time point
         inline bool check() const { return PTimer->GetTime() >= Expected; }  // check if the time has come
     };
@@ -64,8 +155,9 @@ namespace Perspective
 // ------------------------------- Repeater ---------------------------------
 
     // simple template class. Provides functionality for repeatedly performed
-    // time checks based on a specific timer.
-    template<class TimerType = Timer>
+    // time checks based on a specific timer. ClockT is a clock source for
+    // "since now" requests.
+    template<class TimerType = Timer, class ClockT = ProgramClock>
     class Repeater
     {
     protected:
@@ -76,9 +168,461 @@ namespace Perspective
         // simple constructor for setting Timer pointer and optianally repeat period
         Repeater( TimerType* PT, const Duration& Per = seconds( 1 ) ) : PTimer( PT ), Period( Per ) {}
 
-        inline void repeat( const Duration& Per ) { Expected = ProgramTime() + (Period = Per); }  // call for repeating with new period
+        inline void repeat( const Duration& Per ) { Expected = ClockT::now() + (Period = Per); }  // call for repeating with new period
         inline void repeat() { Expected += Period; }  // call for repeating with same period
         inline bool check() const { return PTimer->GetTime() >= Expected; }  // check if the time has come
     };
 
+// --------------------------- Concurrent Timer -----------------------------
+
+    // Timer readable from any thread while a single writer thread updates it.
+    // Writer works with a private PausableTimer and publishes Start, Stop and
+    // Counted moments under a sequence lock: no locks on either side, readers
+    // retry only if they overlap a publication. Readers never write shared
+    // memory, so they don't steal the cache line from the writer. Occupies
+    // two cache lines: the published one read by everybody and the
+    // writer-private one, so writer updates don't invalidate it for readers
+    // until the publication.
+    template<class ClockT = ProgramClock>
+    class alignas( 64 ) ConcurrentTimer
+    {
+    public:
+        // consistent published state
+        struct Snapshot
+        {
+            Duration Start;  // a moment of Start event
+            Duration Stop;  // a moment of Stop event or PrestartT-like -1 if IsOn
+            Duration Counted;  // amount of counted time at last writer update
+            inline bool IsOn() const { return Stop < Start; }
+        };
+
+    protected:
+        std::atomic<uint32_t> Seq{ 0 };  // odd while the writer publishes
+        std::atomic<time_tick_t> PubStart;  // published Start moment
+        std::atomic<time_tick_t> PubStop;  // published Stop moment
+        std::atomic<time_tick_t> PubCounted;  // published counted time
+
+        alignas( 64 ) PausableTimer<ClockT> Core;  // writer-private counting logic, own cache line
+        Duration StartT;  // writer-private Start moment
+
+        inline void Publish()
+        {
+            uint32_t S = Seq.load( std::memory_order_relaxed );
+            Seq.store( S + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            PubStart.store( StartT.getTicks(), std::memory_order_relaxed );
+            PubStop.store( Core.IsOn() ? -1 : Core.GetLast().getTicks(), std::memory_order_relaxed );
+            PubCounted.store( Core.GetTime().getTicks(), std::memory_order_relaxed );
+            Seq.store( S + 2, std::memory_order_release );
+        }
+
+    public:
+        ConcurrentTimer() : ConcurrentTimer( ClockT::now() ) {}  // does NOT start the timer
+        explicit ConcurrentTimer( const Duration& Now ) : Core( Now ), StartT( Now ) { Publish(); }
+
+// ----------------------- Writer side (single thread) ----------------------
+
+        inline void StartAt( const Duration& Now, const Duration& dt = ZERO_Duration ) { StartT = Now; Core.StartAt( Now, dt ); Publish(); }
+        inline Duration StopAt( const Duration& Now ) { Core.StopAt( Now ); Publish(); return Core.GetTime(); }
+        inline Duration ResetAt( const Duration& Now, const Duration& dt = ZERO_Duration ) { StartT = Now; Duration Prev = Core.ResetAt( Now, dt ); Publish(); return Prev; }
+        inline Duration RestartAt( const Duration& Now, const Duration& dt = ZERO_Duration ) { StartT = Now; Duration Prev = Core.RestartAt( Now, dt ); Publish(); return Prev; }
+        inline Duration UpdateAt( const Duration& Now ) { Core.UpdateAt( Now ); Publish(); return Core.GetTime(); }
+
+        inline void Start( const Duration& dt = ZERO_Duration ) { StartAt( ClockT::now(), dt ); }
+        inline Duration Stop() { return StopAt( ClockT::now() ); }
+        inline Duration Reset( const Duration& dt = ZERO_Duration ) { return ResetAt( ClockT::now(), dt ); }
+        inline Duration Restart( const Duration& dt = ZERO_Duration ) { return RestartAt( ClockT::now(), dt ); }
+        inline Duration Update() { return Core.IsOn() ? UpdateAt( ClockT::now() ) : Core.GetTime(); }
+
+// --------------------------- Reader side (any thread) ---------------------
+
+        // consistent copy of Start, Stop and Counted values
+        inline Snapshot Read() const
+        {
+            Snapshot Res;
+            uint32_t Before, After;
+            do
+            {
+                Before = Seq.load( std::memory_order_acquire );
+                Res.Start = Duration( PubStart.load( std::memory_order_relaxed ) );
+                Res.Stop = Duration( PubStop.load( std::memory_order_relaxed ) );
+                Res.Counted = Duration( PubCounted.load( std::memory_order_relaxed ) );
+                std::atomic_thread_fence( std::memory_order_acquire );
+                After = Seq.load( std::memory_order_relaxed );
+            } while ((Before & 1) || Before != After);
+            return Res;
+        }
+
+        inline Duration GetTime() const { return Duration( PubCounted.load( std::memory_order_relaxed ) ); }  // single value needs no retry loop
+        inline Duration GetStart() const { return Duration( PubStart.load( std::memory_order_relaxed ) ); }
+        inline Duration GetStop() const { return Duration( PubStop.load( std::memory_order_relaxed ) ); }
+        inline bool IsOn() const { Snapshot S = Read(); return S.IsOn(); }
+    };
+
+// --------------------------- Periodic Sleeper -----------------------------
+
+    // paces a loop with fixed period on absolute deadlines, so a slow
+    // iteration doesn't shift all the following ones. Missed periods are
+    // skipped (no catch-up burst) and reported as overruns.
+    class PeriodicSleeper
+    {
+    protected:
+        Duration Period;  // loop period
+        Duration Next;  // next deadline (duration since program start)
+        Duration Lateness{ ZERO_Duration };  // how late the last Wait() returned
+        uint64_t Overruns = 0;  // total amount of missed periods
+        bool Precise;  // use hybrid precise sleep
+    public:
+        // first deadline is one period since now. Period <= 0 is clamped to the smallest one
+        PeriodicSleeper( const Duration& Per, bool Prec = true )
+            : Period( Per.getTicks() > 0 ? Per : SMALLEST_Duration ), Next( ProgramTime() + Period ), Precise( Prec ) {}
+
+        bool Wait();  // sleeps until the next deadline. Returns false if the deadline was already missed
+        inline void Reset() { Next = ProgramTime() + Period; }  // re-anchors deadlines to now
+        inline void SetPeriod( const Duration& Per ) { Period = Per.getTicks() > 0 ? Per : SMALLEST_Duration; Reset(); }
+
+        inline const Duration& GetPeriod() const { return Period; }
+        inline const Duration& GetNext() const { return Next; }  // next deadline
+        inline const Duration& GetLateness() const { return Lateness; }  // wake-up error of the last Wait()
+        inline uint64_t GetOverruns() const { return Overruns; }  // total amount of missed periods
+    };
+
+// ----------------------------- Timing Wheel -------------------------------
+
+    // Hierarchical timing wheel for masses of one-shot and periodic deadlines
+    // (AI, cooldowns). Replaces per-object polling: schedule, cancel and
+    // expire cost O(1) regardless of the amount of timers. Time is quantized
+    // into ticks of given granularity, deadlines are never reported early.
+    // 4 levels of 256 slots cover 2^32 ticks, farther deadlines are parked in
+    // the last slot and re-cascaded. Driven by ProgramTime() or any other
+    // Duration since program start passed to Advance(). Not thread-safe.
+    class TimingWheel
+    {
+    public:
+        typedef uint64_t TimerId;  // generation in high half, pool index in low half
+        static const TimerId INVALID_TIMER = ~(TimerId)0;
+
+        // single expired deadline
+        struct Expired
+        {
+            TimerId Id;  // id returned by Schedule*
+            uint64_t UserData;  // value passed to Schedule*
+        };
+
+    protected:
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 8;
+        static const uint32_t SLOTS = 1u << SLOT_BITS;
+        static const uint32_t SLOT_MASK = SLOTS - 1;
+        static const uint32_t NIL = ~(uint32_t)0;
+
+        struct Entry
+        {
+            uint64_t Deadline;  // tick of expiration
+            uint64_t Period;  // period in ticks, 0 for one-shot
+            uint64_t UserData;  // user value
+            uint32_t Prev, Next;  // intrusive slot list
+            uint32_t Slot;  // slot index in Heads, NIL if not scheduled
+            uint32_t Gen;  // generation for stale id detection
+        };
+
+        std::vector<Entry> Pool;  // all entries, reused through FreeHead
+        std::vector<Expired> Batch;  // expired entries of the last Advance()
+        uint32_t Heads[LEVELS * SLOTS];  // slot list heads
+        uint32_t FreeHead = NIL;  // free entries list (linked through Next)
+        size_t Active = 0;  // amount of scheduled entries
+
+        Duration Origin;  // moment of tick 0
+        Duration Granularity;  // tick length
+        uint64_t Current = 0;  // next tick to be processed
+
+        uint64_t ToTick( const Duration& Moment ) const;  // rounds up, so deadlines never come early
+        void Link( uint32_t Index );  // places scheduled entry into its slot
+        void Unlink( uint32_t Index );  // removes entry from its slot
+        void Cascade( int Level, uint32_t Slot );  // redistributes higher level slot into lower levels
+        TimerId Insert( uint64_t Deadline, uint64_t Period, uint64_t UserData );
+
+    public:
+        // tick granularity and moment of tick 0 (now by default)
+        explicit TimingWheel( const Duration& Gran = millisec( 1 ), const Duration& Start = ProgramTime() );
+
+        void Reserve( size_t Count );  // preallocates entries
+
+        TimerId ScheduleAt( const Duration& Deadline, uint64_t UserData = 0 );  // one-shot at a moment since program start
+        TimerId Schedule( const Duration& Delay, uint64_t UserData = 0 ) { return ScheduleAt( ProgramTime() + Delay, UserData ); }  // one-shot after a delay
+        TimerId SchedulePeriodicAt( const Duration& First, const Duration& Period, uint64_t UserData = 0 );  // first at a moment since program start, then every Period until canceled
+        TimerId SchedulePeriodic( const Duration& Period, uint64_t UserData = 0 ) { return SchedulePeriodicAt( ProgramTime() + Period, Period, UserData ); }  // every Period since now until canceled
+        bool Cancel( TimerId Id );  // returns false if the timer has already expired or was canceled
+        bool IsScheduled( TimerId Id ) const;
+
+        // Processes all ticks up to Now and returns the batch of expired
+        // deadlines in expiration order. Periodic timers are rescheduled
+        // from their deadline (no drift). Batch is valid until next Advance()
+        const std::vector<Expired>& Advance( const Duration& Now );
+        const std::vector<Expired>& Advance() { return Advance( ProgramTime() ); }
+
+        // same as Advance(), but calls OnExpire( Id, UserData ) for every
+        // expired deadline. Returns amount of calls
+        template<class Callback>
+        size_t Advance( const Duration& Now, Callback&& OnExpire )
+        {
+            const std::vector<Expired>& Res = Advance( Now );
+            for (size_t i = 0; i < Res.size(); i++)
+                OnExpire( Res[i].Id, Res[i].UserData );
+            return Res.size();
+        }
+
+        inline size_t Size() const { return Active; }  // amount of scheduled timers
+        inline const Duration& GetGranularity() const { return Granularity; }
+        inline Duration GetNow() const { return Origin + Duration( time_tick_t( Current ) * Granularity.getTicks() ); }  // moment of the next tick to be processed
+    };
+
+// --------------------------- Budget Scheduler -----------------------------
+
+    // Spreads long work (texture decoding, data parsing, scripts) across
+    // frames. Work items are resumable: every call does a chunk of work,
+    // checks the budget and returns true once finished. Run( Budget ) calls
+    // items round-robin until the budget measured with ElementaryTimer is
+    // used up. Items yield cooperatively, so the budget may be exceeded by
+    // one chunk. An item waiting for something (file read, other thread)
+    // calls Slice::Idle() before returning: Run leaves early once a full
+    // round of items made no progress, instead of spinning out the budget.
+    // Submit, Cancel and queries are thread-safe, Run is called by a single
+    // (frame) thread.
+    class BudgetScheduler
+    {
+    public:
+        typedef uint64_t TaskId;
+        static const TaskId INVALID_TASK = 0;
+
+        // passed to work items: budget checks and progress reports
+        class Slice
+        {
+            friend class BudgetScheduler;
+        protected:
+            const ElementaryTimer& Clock;  // measures the current Run
+            Duration Budget;  // budget of the current Run
+            float Progress;  // progress reported by the item, [0, 1]
+            bool Stalled;  // the item reported no progress in this call
+
+            Slice( const ElementaryTimer& C, const Duration& B, float P ) : Clock( C ), Budget( B ), Progress( P ), Stalled( false ) {}
+        public:
+            inline bool Expired() const { return Clock.GetTime() >= Budget; }  // item should return as soon as possible
+            inline Duration Remaining() const { return Budget - Clock.GetTime(); }
+            inline void SetProgress( float P ) { Progress = P < 0 ? 0 : P > 1 ? 1 : P; }
+            inline void Idle() { Stalled = true; }  // nothing was done in this call, the item waits for something
+            inline float GetProgress() const { return Progress; }
+        };
+
+        // does a chunk of work, returns true when the whole item is finished
+        typedef std::function<bool( Slice& )> WorkItem;
+
+    protected:
+        struct Task
+        {
+            TaskId Id;
+            WorkItem Work;
+            float Progress;
+        };
+
+        std::vector<Task> Tasks;  // owned by Run
+        std::vector<Task> Submitted;  // waiting to be taken by Run
+        std::vector<TaskId> Canceled;  // waiting to be removed by Run
+        std::vector<std::pair<TaskId, float>> Progress;  // published progress of unfinished tasks, sorted by id
+        mutable std::mutex Guard;  // protects Submitted, Canceled, Progress
+        TaskId NextId = 1;
+        size_t Cursor = 0;  // round-robin position, next Run continues from it
+        Duration LastUsed{ ZERO_Duration };  // time spent by the last Run
+    public:
+        TaskId Submit( WorkItem Work );  // queues a work item, runs from the next Run
+        bool Cancel( TaskId Id );  // removes the item before its next call. Returns false if it is not pending
+
+        // calls work items until Budget is used up or no items remain.
+        // Returns amount of items finished during the call
+        size_t Run( const Duration& Budget );
+
+        bool IsPending( TaskId Id ) const;  // true until the item is finished or canceled
+        float GetProgress( TaskId Id ) const;  // last reported progress, 1 if finished or unknown
+        size_t Size() const;  // amount of pending items
+        inline const Duration& GetLastUsed() const { return LastUsed; }  // time spent by the last Run, exceeds the budget by the overrun
+    };
+
+// ----------------------------- Timed Event --------------------------------
+
+    // Event for cross-thread wake-ups with Duration and Time deadlines. Set()
+    // costs an atomic exchange and a load while nobody waits; waiters sleep in the
+    // kernel (no polling) and wake within the OS scheduling latency.
+    // Auto-reset event releases a single waiter per Set(), manual-reset one
+    // releases all waiters until Reset()
+    class TimedEvent
+    {
+    protected:
+        std::atomic<uint32_t> State{ 0 };  // 1 - signaled
+        std::atomic<uint32_t> Waiters{ 0 };  // amount of threads about to sleep or sleeping
+        bool AutoReset;
+    public:
+        explicit TimedEvent( bool Auto = true ) : AutoReset( Auto ) {}
+
+        TimedEvent( const TimedEvent& ) = delete;
+        TimedEvent& operator= ( const TimedEvent& ) = delete;
+
+        void Set();  // signals the event, wakes a waiter (all waiters if manual-reset)
+        inline void Reset() { State.store( 0, std::memory_order_release ); }  // clears signaled state
+        inline bool IsSet() const { return State.load( std::memory_order_acquire ) != 0; }
+
+        bool TryWait();  // consumes signal without blocking (auto-reset). Returns false if not signaled
+        bool WaitUntil( const Duration& Deadline );  // moment since program start. Returns false on timeout
+        inline bool WaitUntil( const Time& Deadline ) { return WaitUntil( Deadline - Time() ); }
+        inline bool WaitFor( const Duration& Timeout ) { return WaitUntil( ProgramTime() + Timeout ); }
+        inline void Wait() { WaitUntil( MAX_Duration ); }
+    };
+
+// ---------------------------- Timed Semaphore -----------------------------
+
+    // Counting semaphore with Duration and Time deadlines. Release() costs an
+    // atomic add and a load while nobody waits
+    class TimedSemaphore
+    {
+    protected:
+        std::atomic<uint32_t> Count;  // available units
+        std::atomic<uint32_t> Waiters{ 0 };  // amount of threads about to sleep or sleeping
+    public:
+        explicit TimedSemaphore( uint32_t Initial = 0 ) : Count( Initial ) {}
+
+        TimedSemaphore( const TimedSemaphore& ) = delete;
+        TimedSemaphore& operator= ( const TimedSemaphore& ) = delete;
+
+        void Release( uint32_t N = 1 );  // adds N units, wakes waiters
+        bool TryAcquire();  // takes a unit without blocking. Returns false if none
+        bool AcquireUntil( const Duration& Deadline );  // moment since program start. Returns false on timeout
+        inline bool AcquireUntil( const Time& Deadline ) { return AcquireUntil( Deadline - Time() ); }
+        inline bool AcquireFor( const Duration& Timeout ) { return AcquireUntil( ProgramTime() + Timeout ); }
+        inline void Acquire() { AcquireUntil( MAX_Duration ); }
+
+        inline uint32_t Available() const { return Count.load( std::memory_order_relaxed ); }
+    };
+
+// ----------------------------- Rate Limiter -------------------------------
+
+    // true for clocks which stand still between frames, so sleeping doesn't
+    // move them. Coarse clocks move, only in steps
+    template<class ClockT> struct _frozen_clock : std::false_type {};
+    template<> struct _frozen_clock<FrameClock> : std::true_type {};
+
+    // Lock-free token bucket: Rate units per second with bursts up to Burst
+    // units. Stored as a single word - the moment the bucket becomes full
+    // again (GCRA form of the token bucket), so acquiring is one CAS and
+    // refill is implicit in the clock reading. ClockT is CoarseProgramClock
+    // by default (a single load with the coarse ticker), FrameClock limits
+    // per frame. Any thread may acquire.
+    template<class ClockT = CoarseProgramClock>
+    class BasicRateLimiter
+    {
+    protected:
+        static const int FRAC_BITS = 8;  // fixed point: rates up to 256 units per tick
+
+        std::atomic<time_tick_t> Full;  // moment the bucket becomes full, 1 / 2^FRAC_BITS ticks
+        time_tick_t Cost;  // time of a single unit refill, 1 / 2^FRAC_BITS ticks
+        time_tick_t Capacity;  // Burst * Cost
+
+        static inline time_tick_t _Fixed( const Duration& dt ) { return dt.getTicks() * (time_tick_t( 1 ) << FRAC_BITS); }
+        // largest unit cost keeping Capacity and moment sums representable
+        static inline time_tick_t _MaxCost( uint32_t Burst ) { return MAX_TICK / 4 / time_tick_t( Burst ? Burst : 1 ); }
+    public:
+        typedef ClockT clock_type;
+
+        // starts full. With an invalid Rate never refills: grants Burst once
+        BasicRateLimiter( time_real_t Rate, uint32_t Burst ) : Full( MIN_TICK / 2 )
+        {
+            if (!SetRate( Rate, Burst ))
+            {
+                Cost = _MaxCost( Burst );
+                Capacity = Cost * time_tick_t( Burst ? Burst : 1 );
+            }
+        }
+
+        BasicRateLimiter( const BasicRateLimiter& ) = delete;
+        BasicRateLimiter& operator= ( const BasicRateLimiter& ) = delete;
+
+        // not synchronized with concurrent acquires: set up before sharing.
+        // Rate must be positive and finite, otherwise returns false and keeps
+        // the previous setup. Rates too slow to represent are clamped
+        bool SetRate( time_real_t Rate, uint32_t Burst )
+        {
+            if (!(Rate > 0) || !std::isfinite( Rate ))  // NaN fails the comparison
+                return false;
+            time_real_t C = time_real_t( TICKS_PER_SEC ) * time_real_t( time_tick_t( 1 ) << FRAC_BITS ) / Rate;
+            time_tick_t Max = _MaxCost( Burst );
+            Cost = C < 1 ? 1 : C > time_real_t( Max ) ? Max : time_tick_t( C );  // in range before the conversion
+            Capacity = Cost * time_tick_t( Burst ? Burst : 1 );
+            return true;
+        }
+
+        // takes N units if available at the moment Now. Returns false otherwise
+        bool TryAcquireAt( const Duration& Now, uint32_t N = 1 )
+        {
+            if (time_tick_t( N ) > Capacity / Cost)  // exceeds the burst, Cost * N may overflow
+                return false;
+            time_tick_t T = _Fixed( Now );
+            time_tick_t F = Full.load( std::memory_order_relaxed );
+            for (;;)
+            {
+                time_tick_t Next = (F > T ? F : T) + Cost * time_tick_t( N );
+                if (Next - T > Capacity)
+                    return false;
+                if (Full.compare_exchange_weak( F, Next, std::memory_order_relaxed ))
+                    return true;
+            }
+        }
+        inline bool TryAcquire( uint32_t N = 1 ) { return TryAcquireAt( ClockT::now(), N ); }
+
+        // time until N units are available, ZERO_Duration if they are now
+        // and MAX_Duration if N exceeds the burst
+        Duration WaitTimeAt( const Duration& Now, uint32_t N = 1 ) const
+        {
+            if (time_tick_t( N ) > Capacity / Cost)  // checked before Cost * N may overflow
+                return MAX_Duration;
+            time_tick_t T = _Fixed( Now );
+            time_tick_t F = Full.load( std::memory_order_relaxed );
+            time_tick_t Over = (F > T ? F : T) + Cost * time_tick_t( N ) - T - Capacity;
+            return Over > 0 ? Duration( (Over + (time_tick_t( 1 ) << FRAC_BITS) - 1) >> FRAC_BITS ) : ZERO_Duration;
+        }
+        inline Duration WaitTime( uint32_t N = 1 ) const { return WaitTimeAt( ClockT::now(), N ); }
+
+        // takes N units, sleeping until they are available. Returns false at
+        // once if they can't be available by Deadline (ClockT time). A coarse
+        // clock may not move during a short sleep: then sleeps again until
+        // it does, the deadline itself is checked on the precise clock
+        bool AcquireUntil( uint32_t N, const Duration& Deadline )
+        {
+            for (;;)
+            {
+                Duration Now = ClockT::now();
+                if (TryAcquireAt( Now, N ))
+                    return true;
+                Duration Wait = WaitTimeAt( Now, N );
+                if (Wait == MAX_Duration || Now + Wait > Deadline)
+                    return false;
+                if (!_frozen_clock<ClockT>::value && ProgramTime() >= Deadline)
+                    return false;
+                Sleep( Wait );
+                if (_frozen_clock<ClockT>::value && ClockT::now() == Now)  // waits for the next frame otherwise
+                    return TryAcquire( N );
+            }
+        }
+        inline bool AcquireFor( uint32_t N, const Duration& Timeout ) { return AcquireUntil( N, ClockT::now() + Timeout ); }
+
+        // amount of units available at the moment Now
+        inline time_real_t AvailableAt( const Duration& Now ) const
+        {
+            time_tick_t T = _Fixed( Now );
+            time_tick_t F = Full.load( std::memory_order_relaxed );
+            return time_real_t( Capacity - ((F > T ? F : T) - T) ) / time_real_t( Cost );
+        }
+        inline time_real_t Available() const { return AvailableAt( ClockT::now() ); }
+    };
+
+    typedef BasicRateLimiter<CoarseProgramClock> RateLimiter;  // refills from the coarse clock
+    typedef BasicRateLimiter<ProgramClock> PreciseRateLimiter;  // refills from the precise clock
+    typedef BasicRateLimiter<FrameClock> FrameRateLimiter;  // refills once per frame
 }
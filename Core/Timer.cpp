@@ -5,95 +5,401 @@
 // ------------------------- Project dependencies ---------------------------
 #include "Timer.hpp"
 
+// Standart dependencies: <thread>, <mutex>
+#include <thread>  // coarse ticker
+#include <mutex>
+
+#ifdef _WIN32
+#include <Windows.h>  // GetThreadTimes
+#endif
+
+#if defined(PER_TIME_TSC) && defined(PER_TIME_TSC_AVAILABLE) && !defined(_MSC_VER)
+#include <cpuid.h>  // __get_cpuid
+#endif
+
 namespace Perspective
 {
 
-// ~~~~~~~~~~~~~~~~~~~~~~ OS-independent instantiations ~~~~~~~~~~~~~~~~~~~~~
+#ifdef PER_TIME_TSC
 
-    // protected static technical variable for temporal conversions to integer seconds
-    time_t Time::sex{ 0 };
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TSC calibration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    // protected static constant for storaging approximate program start time
-    const time_tick_t Time::start_ticks = SystemTime().getTicks();
+    // zero-initialized: ProgramTime() uses steady_clock until calibrated
+    _TSC_local _TSC_state{};
 
-// =========================== Timer (OS independant) =======================
+    // CPUID.80000007H:EDX[8] - TSC runs at constant rate in all power states
+    static bool _TSC_invariant()
+    {
+#if !defined(PER_TIME_TSC_AVAILABLE)
+        return false;
+#elif defined(_MSC_VER)
+        int Regs[4];
+        __cpuid( Regs, 0x80000000 );
+        if ((unsigned)Regs[0] < 0x80000007u)
+            return false;
+        __cpuid( Regs, 0x80000007 );
+        return (Regs[3] & (1 << 8)) != 0;
+#else
+        unsigned A, B, C, D;
+        if (!__get_cpuid( 0x80000007u, &A, &B, &C, &D ))
+            return false;
+        return (D & (1u << 8)) != 0;
+#endif
+    }
 
-    // protected static constant for the reset of Stop time
-    const Duration Timer::PrestartT = Duration( -1 );
+    // simultaneous TSC and steady_clock reading. Takes the most tightly
+    // bracketed of several attempts to filter out preemptions
+    static _TSC_calibration _TSC_sample()
+    {
+        _TSC_calibration Best{ 0, 0, 0, 0, 0, 0 };
+        uint64_t BestSpan = ~(uint64_t)0;
+        for (int i = 0; i < 5; ++i)
+        {
+            uint64_t Before = _TSC_read();
+            time_tick_t Ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+            uint64_t After = _TSC_read();
+            if (After - Before < BestSpan)
+            {
+                BestSpan = After - Before;
+                Best.BaseCycles = Before + BestSpan / 2;
+                Best.BaseTicks = Ticks;
+            }
+        }
+        return Best;
+    }
 
-    // default constructor. Does NOT start the timer
-    Timer::Timer()
+    // ticks per cycle between two samples
+    static double _TSC_ticks_per_cycle( const _TSC_calibration& From, const _TSC_calibration& To )
     {
-        StartT = StopT = LastT = ProgramTime();
+        return double( To.BaseTicks - From.BaseTicks ) / double( To.BaseCycles - From.BaseCycles );
     }
 
-    // Start function. Timer starts calculating time if has not been calculating
-    // before. Adds argument dt to allready calculated time
-    void Timer::Start( const Duration& dt )
+    // converts ticks per cycle into _TSC_calibration::Mult fixed-point format
+    static int64_t _TSC_fixed( double TicksPerCycle )
     {
-        StartT = LastT = ProgramTime();
-        StopT = PrestartT;
-        CountedT += dt;
+        return int64_t( TicksPerCycle * double( (uint64_t)1 << _TSC_SHIFT ) + 0.5 );
     }
 
-    // Timer stops calculating time. If has been calculating before call - updates
-    // calculated time before stop. Returns calculated time
-    Duration Timer::Stop()
+    // publishes a calibration under the seqlock. Single writer
+    static void _TSC_publish( const _TSC_calibration& C )
+    {
+        uint32_t Seq = _TSC_state.Seq.load( std::memory_order_relaxed );
+        _TSC_state.Seq.store( Seq + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        _TSC_state.BaseCycles.store( C.BaseCycles, std::memory_order_relaxed );
+        _TSC_state.BaseTicks.store( C.BaseTicks, std::memory_order_relaxed );
+        _TSC_state.Mult.store( C.Mult, std::memory_order_relaxed );
+        _TSC_state.SlewCycles.store( C.SlewCycles, std::memory_order_relaxed );
+        _TSC_state.SlewTicks.store( C.SlewTicks, std::memory_order_relaxed );
+        _TSC_state.SlewMult.store( C.SlewMult, std::memory_order_relaxed );
+        _TSC_state.Seq.store( Seq + 2, std::memory_order_release );
+    }
+
+    static std::atomic<bool> _TSC_checking{ false };  // single writer guard
+    static std::atomic<int> _TSC_phase{ 0 };  // 0 - not started, 1 - origin taken, 2 - calibrated or not invariant
+
+    // lazy calibration: the origin on the first reading, the rate over the
+    // 2 ms since then. Precision is improved later by CheckTSCCalibration()
+    // over a longer baseline. Steady ticks returned meanwhile are the same
+    // domain as TSC-based ones
+    time_tick_t _TSC_fallback()
+    {
+        time_tick_t Now = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (_TSC_phase.load( std::memory_order_acquire ) == 2)
+            return Now;
+        if (_TSC_checking.exchange( true, std::memory_order_acquire ))
+            return Now;  // another thread calibrates right now
+
+        int Phase = _TSC_phase.load( std::memory_order_relaxed );
+        if (Phase == 0)
+        {
+            if (_TSC_invariant())
+            {
+                _TSC_state.Origin = _TSC_sample();
+                Phase = 1;
+            }
+            else
+                Phase = 2;
+        }
+        else if (Phase == 1 && Now - _TSC_state.Origin.BaseTicks >= TICKS_PER_SEC / 500)
+        {
+            _TSC_calibration End = _TSC_sample();
+            End.Mult = End.SlewMult = _TSC_fixed( _TSC_ticks_per_cycle( _TSC_state.Origin, End ) );
+            _TSC_publish( End );
+            Phase = 2;
+        }
+        _TSC_phase.store( Phase, std::memory_order_release );
+        _TSC_checking.store( false, std::memory_order_release );
+        return Now;
+    }
+
+    // Compares TSC-based time with steady_clock. If the error exceeds the
+    // tolerance - republishes a calibration with refined frequency which
+    // slews the error out within one second and runs at the refined rate
+    // afterwards, so ProgramTime() stays monotonic.
+    bool CheckTSCCalibration( const Duration& Tolerance )
     {
-        TempT = ProgramTime();
-        if (StopT < StartT)
+        _TSC_calibration C;
+        if (!_TSC_load( C ))
+            return false;
+        if (_TSC_checking.exchange( true, std::memory_order_acquire ))
+            return true;  // another thread is checking right now
+
+        _TSC_calibration Now = _TSC_sample();
+        time_tick_t Predicted = _TSC_convert( C, Now.BaseCycles );
+        time_tick_t Error = Predicted - Now.BaseTicks;
+        bool Valid = Error <= Tolerance.getTicks() && -Error <= Tolerance.getTicks();
+
+        if (!Valid)
         {
-            CountedT += TempT - LastT;
-            LastT = TempT;
+            _TSC_calibration Next = Now;
+            double Rate = _TSC_ticks_per_cycle( _TSC_state.Origin, Now );
+            Next.Mult = Next.SlewMult = _TSC_fixed( Rate );
+            if (Error < TICKS_PER_SEC / 2 && -Error < TICKS_PER_SEC / 2)
+            {
+                // slew: continue from the predicted value, count TICKS_PER_SEC - Error
+                // ticks during the next second, then the refined rate
+                Next.BaseTicks = Predicted;
+                Next.SlewCycles = uint64_t( double( TICKS_PER_SEC ) / Rate );
+                Next.SlewMult = _TSC_fixed( Rate * double( TICKS_PER_SEC - Error ) / double( TICKS_PER_SEC ) );
+                Next.SlewTicks = _TSC_scale( (int64_t)Next.SlewCycles, Next.SlewMult );
+            }
+            // too far to slew otherwise - step to steady_clock
+            _TSC_publish( Next );
         }
-        StopT = TempT;
-        return CountedT;
+
+        _TSC_checking.store( false, std::memory_order_release );
+        return Valid;
     }
 
-    // if Timer IsOn - updates calculated time. Resets timer. Calculated time is
-    // set to dt. Returns previously calculated time
-    Duration Timer::Reset( const Duration& dt )
+    // true if ProgramTime() is served by TSC
+    bool IsTSCActive()
     {
-        TempT = ProgramTime();
+        return _TSC_state.Seq.load( std::memory_order_relaxed ) != 0;
+    }
+
+#endif
 
-        if (StopT < StartT)
-            CountedT += TempT - LastT;
+// ~~~~~~~~~~~~~~~~~~~~~~ OS-independent instantiations ~~~~~~~~~~~~~~~~~~~~~
 
-        StopT = StartT = LastT = TempT;
+    // coarse clock publication, zero until the ticker starts
+    _coarse_published _CoarseNow{};
+    std::atomic<TimeSource*> _TimeSourceOverride{ nullptr };  // constant-initialized: valid before any static constructor
 
-        TempT = CountedT;
-        CountedT = dt;
-        return TempT;
+    TimeSource* SetTimeSource( TimeSource* Source )
+    {
+        return _TimeSourceOverride.exchange( Source, std::memory_order_acq_rel );
     }
 
-    // if Timer IsOn - updates calculated time. Restarts timer, setting calculated
-    // time to argument dt. Returns previously calculated time
-    Duration Timer::Restart( const Duration& dt )
+#ifdef PER_TIME_WINDOWS_QPC
+    // tick rate dependent constants, single definitions
+    const time_tick_t TICKS_PER_SEC = _QPC_context().Frequency;
+    const clock_t TICKS_PER_CLOCK = clock_t( TICKS_PER_SEC / CLOCKS_PER_SEC );
+    const time_real_t SEC_PER_TICK = 1. / TICKS_PER_SEC;
+    const time_real_t USEC_PER_TICK = 1000000. / TICKS_PER_SEC;
+    const time_real_t MSEC_PER_TICK = 1000. / TICKS_PER_SEC;
+#else
+    // program start anchors, taken by the first clock reading
+    _time_context _TimeContext{};
+
+    time_tick_t _TimeContextInit()
+    {
+        // raw clocks: SystemTime() may be served by an installed TimeSource
+#ifdef PER_TIME_TSC
+        time_tick_t Now = _TSC_now();
+#else
+        time_tick_t Now = std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        time_tick_t Expected = 0;
+        _TimeContext.StartGlobalTicks.compare_exchange_strong( Expected,
+            std::chrono::system_clock::now().time_since_epoch().count(), std::memory_order_acq_rel );
+        Expected = 0;  // global anchor is published first: StartTicks != 0 implies both are taken
+        if (_TimeContext.StartTicks.compare_exchange_strong( Expected, Now, std::memory_order_acq_rel ))
+            return Now;
+        return Expected;  // taken by another thread
+    }
+#endif
+
+// ======================= Thread CPU time (OS dependant) ===================
+
+    // CPU time consumed by the calling thread
+    Duration ThreadCPUTime()
+    {
+#if defined(_WIN32)
+        FILETIME Creation, Exit, Kernel, User;  // 100 ns units
+        GetThreadTimes( GetCurrentThread(), &Creation, &Exit, &Kernel, &User );
+        time_int64_t Units = ((time_int64_t)Kernel.dwHighDateTime << 32 | Kernel.dwLowDateTime) +
+            ((time_int64_t)User.dwHighDateTime << 32 | User.dwLowDateTime);
+        return Duration( time_tick_t( Units * TICKS_PER_SEC / 10000000 ) );
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec Ts;
+        clock_gettime( CLOCK_THREAD_CPUTIME_ID, &Ts );
+        return Duration( (time_tick_t)Ts.tv_sec * TICKS_PER_SEC + (time_tick_t)Ts.tv_nsec * TICKS_PER_SEC / 1000000000 );
+#else
+        return ConsumedTime();  // no per-thread clock - process-wide approximation
+#endif
+    }
+
+// ============================ Time (OS independant) =======================
+
+    // C-style struct tm conversion. Uses reentrant localtime versions
+    tm Time::as_tm() const
     {
-        TempT = ProgramTime();
+        time_t Sec = as_time_t();
+        tm Res;
+#ifdef _WIN32
+        localtime_s( &Res, &Sec );
+#else
+        localtime_r( &Sec, &Res );
+#endif
+        return Res;
+    }
+
+    // C-style date-stamp conversion into thread-local buffer
+    char* Time::as_c_str() const
+    {
+        static thread_local char Buf[32];  // ctime format takes 26 chars
+        time_t Sec = as_time_t();
+#ifdef _WIN32
+        ctime_s( Buf, sizeof( Buf ), &Sec );
+#else
+        ctime_r( &Sec, Buf );
+#endif
+        return Buf;
+    }
 
-        if (StopT < StartT)
-            CountedT += TempT - LastT;
+// ======================= FrameClock (OS independant) ======================
 
-        StartT = LastT = TempT;
-        StopT = PrestartT;
+    std::atomic<time_tick_t> FrameClock::NowTicks{ 0 };
+    std::atomic<time_tick_t> FrameClock::DeltaTicks{ 0 };
+    std::atomic<uint64_t> FrameClock::Frame{ 0 };
 
-        TempT = CountedT;
-        CountedT = dt;
-        return TempT;
+    // samples ProgramTime() for the new frame
+    Duration FrameClock::Tick()
+    {
+        time_tick_t Now = ProgramTime().getTicks();
+        time_tick_t Delta = Now - NowTicks.load( std::memory_order_relaxed );
+        DeltaTicks.store( Delta, std::memory_order_relaxed );
+        NowTicks.store( Now, std::memory_order_relaxed );
+        Frame.fetch_add( 1, std::memory_order_relaxed );
+        return Duration( Delta );
     }
 
-    // if Timer IsOn (means Stop < Start) updates calculated time. Returns
-    // calculated time
-    Duration Timer::Update()
+// ========================= Coarse ticker (OS independant) =================
+
+    // background thread publishing SystemTime() into _CoarseNow
+    struct _coarse_ticker
     {
-        if (StopT < StartT)
+        std::mutex Guard;  // serializes start/stop
+        std::thread Thread;
+        std::atomic<bool> Run{ false };
+
+        void Stop()
         {
-            TempT = ProgramTime();
-            CountedT += TempT - LastT;
-            LastT = TempT;
+            std::lock_guard<std::mutex> Lock( Guard );
+            if (!Thread.joinable())
+                return;
+            Run.store( false, std::memory_order_relaxed );
+            Thread.join();
+            _CoarseNow.Floor.store( _CoarseNow.Ticks.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            _CoarseNow.Ticks.store( 0, std::memory_order_relaxed );
         }
-        return CountedT;
+
+        ~_coarse_ticker() { Stop(); }  // joins the thread at exit
+    } static _CoarseTicker;
+
+    void StartCoarseTicker( const Duration& Period )
+    {
+        std::lock_guard<std::mutex> Lock( _CoarseTicker.Guard );
+        if (_CoarseTicker.Thread.joinable())
+            return;
+
+        // publish before the first read, so readers never see a stale value
+        _CoarseNow.Ticks.store( SystemTime().getTicks(), std::memory_order_relaxed );
+        _CoarseTicker.Run.store( true, std::memory_order_relaxed );
+        std::chrono::microseconds Sleep( Period.asMicroSecInt() > 0 ? Period.asMicroSecInt() : 1 );
+        _CoarseTicker.Thread = std::thread( [Sleep]()
+        {
+            while (_CoarseTicker.Run.load( std::memory_order_relaxed ))
+            {
+                std::this_thread::sleep_for( Sleep );
+                _CoarseNow.Ticks.store( SystemTime().getTicks(), std::memory_order_relaxed );
+            }
+        } );
+    }
+
+    void StopCoarseTicker() { _CoarseTicker.Stop(); }
+
+// =========================== Timer (OS independant) =======================
+
+    // protected static constant for the reset of Stop time
+    const Duration Timer::PrestartT = Duration( -1 );
+
+    // default constructor. Does NOT start the timer
+    Timer::Timer() : Timer( ProgramTime() ) {}
+
+    // protected constructor for timers based on another clock
+    Timer::Timer( const Duration& Now ) : Core( Now ), StartT( Now ) {}
+
+    // Start function. Timer starts calculating time if has not been calculating
+    // before. Adds argument dt to allready calculated time
+    void Timer::StartAt( const Duration& Now, const Duration& dt )
+    {
+        StartT = Now;
+        Core.StartAt( Now, dt );
     }
 
+    // Timer stops calculating time. If has been calculating before call - updates
+    // calculated time before stop. Returns calculated time
+    Duration Timer::StopAt( const Duration& Now ) { return Core.StopAt( Now ); }
+
+    // if Timer IsOn - updates calculated time. Resets timer. Calculated time is
+    // set to dt. Returns previously calculated time
+    Duration Timer::ResetAt( const Duration& Now, const Duration& dt )
+    {
+        StartT = Now;
+        return Core.ResetAt( Now, dt );
+    }
+
+    // if Timer IsOn - updates calculated time. Restarts timer, setting calculated
+    // time to argument dt. Returns previously calculated time
+    Duration Timer::RestartAt( const Duration& Now, const Duration& dt )
+    {
+        StartT = Now;
+        return Core.RestartAt( Now, dt );
+    }
+
+    // if Timer IsOn updates calculated time. Returns calculated time
+    Duration Timer::UpdateAt( const Duration& Now ) { return Core.UpdateAt( Now ); }
+
+    void Timer::Start( const Duration& dt ) { StartAt( ProgramTime(), dt ); }
+    Duration Timer::Stop() { return StopAt( ProgramTime() ); }
+    Duration Timer::Reset( const Duration& dt ) { return ResetAt( ProgramTime(), dt ); }
+    Duration Timer::Restart( const Duration& dt ) { return RestartAt( ProgramTime(), dt ); }
+
+    // clock is read only if the timer IsOn
+    Duration Timer::Update() { return Core.IsOn() ? UpdateAt( ProgramTime() ) : Core.GetTime(); }
+
+// ========================== CpuTimer (OS independant) =====================
+
+    // default constructor. Does NOT start the timer
+    CpuTimer::CpuTimer() : Timer( ThreadCPUTime() ) {}
+
+    void CpuTimer::Start( const Duration& dt ) { StartAt( ThreadCPUTime(), dt ); }
+    Duration CpuTimer::Stop() { return StopAt( ThreadCPUTime() ); }
+    Duration CpuTimer::Reset( const Duration& dt ) { return ResetAt( ThreadCPUTime(), dt ); }
+    Duration CpuTimer::Restart( const Duration& dt ) { return RestartAt( ThreadCPUTime(), dt ); }
+    Duration CpuTimer::Update() { return Core.IsOn() ? UpdateAt( ThreadCPUTime() ) : Core.GetTime(); }
+
+// ========================= FrameTimer (OS independant) ====================
+
+    // default constructor. Does NOT start the timer
+    FrameTimer::FrameTimer() : Timer( FrameClock::now() ) {}
+
+    void FrameTimer::Start( const Duration& dt ) { StartAt( FrameClock::now(), dt ); }
+    Duration FrameTimer::Stop() { return StopAt( FrameClock::now() ); }
+    Duration FrameTimer::Reset( const Duration& dt ) { return ResetAt( FrameClock::now(), dt ); }
+    Duration FrameTimer::Restart( const Duration& dt ) { return RestartAt( FrameClock::now(), dt ); }
+    Duration FrameTimer::Update() { return Core.IsOn() ? UpdateAt( FrameClock::now() ) : Core.GetTime(); }
+
 }
@@ -1,9 +1,15 @@
 /*
 * Perspective module for time management.
 * Similar to std::chrono, but self-made accidently.
-* Depends on <ctime>, <cstdint>
-* .cpp depends on <chrono>
+* Depends on <ctime>, <cstdint>, <chrono>, <atomic>
+* .cpp depends on <chrono>, <thread>, <mutex>
 * Several types can be externally defined before first include
+* Clock backend is selected by defining one of the following before first
+* include: PER_TIME_WINDOWS_QPC (Windows performance counter), PER_TIME_TSC
+* (calibrated invariant TSC). std::chrono::steady_clock is used otherwise.
+* Including the header costs no static initialization: constants are
+* constexpr (or defined once in .cpp for QPC) and program start anchors are
+* taken lazily by the first clock reading.
 */
 
 #pragma once
@@ -12,11 +18,23 @@
 #include <time.h>
 #include <stdint.h>
 #include <chrono>
+#include <type_traits>  // std::is_trivially_copyable
+#include <atomic>  // coarse clock publication
 
 #ifdef PER_TIME_WINDOWS_QPC
 #include <Windows.h>
 #endif
 
+#ifdef PER_TIME_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PER_TIME_TSC_AVAILABLE
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PER_TIME_TSC_AVAILABLE
+#endif
+#endif
+
 // ============================== Type declarations =========================
 
 namespace Perspective
@@ -38,8 +56,12 @@ namespace Perspective
     // amount of calculated ticks in one second
     extern const time_tick_t TICKS_PER_SEC;  // defined in .cpp
 
+    // tick rate is known only at runtime - tick conversions can't be constexpr
+#define PER_TIME_TICKS_CONSTEXPR
+
 #else  // std::chrono-based manual implementation (default)
-    
+    // PER_TIME_TSC shares this branch: TSC cycles are rescaled to steady_clock ticks
+
 #ifndef PER_TIME_CHRONO_HYBRID
 #define PER_TIME_CHRONO_HYBRID
 #endif
@@ -54,10 +76,16 @@ namespace Perspective
     typedef std::chrono::steady_clock::rep time_tick_t;
 
     // amount of calculated ticks in one second
-    static const time_tick_t TICKS_PER_SEC =
+    constexpr time_tick_t TICKS_PER_SEC =
         std::chrono::steady_clock::period::den /
         std::chrono::steady_clock::period::num;
 
+    // length of a single tick in seconds as std::ratio
+    typedef std::chrono::steady_clock::period time_tick_period;
+
+    // tick rate is a compile-time constant - tick conversions are constexpr
+#define PER_TIME_TICKS_CONSTEXPR constexpr
+
 #endif
 
 // ---------------------------------------------------------------------------
@@ -83,16 +111,24 @@ namespace Perspective
     //const time_tick_t MAX_TICK = ((time_tick_t)1 << (sizeof( time_tick_t ) * 8 - 1)) - 1;
     //const time_tick_t MIN_TICK = MAX_TICK + 1; //-((time_tick_t)1 << (sizeof( time_tick_t ) * 8 - 1));
 
+#ifdef PER_TIME_WINDOWS_QPC
+    // tick rate dependent constants are defined once in .cpp. Valid after
+    // dynamic initialization of Timer.cpp (clock functions don't use them)
+    extern const clock_t TICKS_PER_CLOCK;  // private constant for transforming ticks into CPU time clocks
+    extern const time_real_t SEC_PER_TICK;  // OS dependent constants for fast but less accurate calculations
+    extern const time_real_t USEC_PER_TICK;
+    extern const time_real_t MSEC_PER_TICK;
+#else
     // Private constant for transforming ticks into CPU time clocks
-    static const clock_t TICKS_PER_CLOCK = TICKS_PER_SEC / CLOCKS_PER_SEC;
+    constexpr clock_t TICKS_PER_CLOCK = TICKS_PER_SEC / CLOCKS_PER_SEC;
 
     // OS dependent constants for fast but less accurate calculations
-    static const time_real_t SEC_PER_TICK = 1. / TICKS_PER_SEC;
+    constexpr time_real_t SEC_PER_TICK = 1. / TICKS_PER_SEC;
+    constexpr time_real_t USEC_PER_TICK = 1000000. / TICKS_PER_SEC;
+    constexpr time_real_t MSEC_PER_TICK = 1000. / TICKS_PER_SEC;
+#endif
 
-    static const time_real_t USEC_PER_TICK = 1000000. / TICKS_PER_SEC;
 #define TICKS_PER_USEC ( TICKS_PER_SEC / 1000000 )
-
-    static const time_real_t MSEC_PER_TICK = 1000. / TICKS_PER_SEC;
 #define TICKS_PER_MSEC ( TICKS_PER_SEC / 1000 )
 
 // ============================ Duration ===================================
@@ -121,15 +157,11 @@ namespace Perspective
 
 // -------------------------- Methods --------------------------------------
 
-        Duration() : ticks( 0 ) {}  // default constructor, creates zero-length time interval.
-        Duration( const time_tick_t& v ) : ticks( v ) {}  // main constructor. May work with clock();
-        Duration( const Duration& dt ) : ticks( dt.ticks ) {}  // copy constructor
+        constexpr Duration() : ticks( 0 ) {}  // default constructor, creates zero-length time interval.
+        constexpr Duration( const time_tick_t& v ) : ticks( v ) {}  // main constructor. May work with clock();
+        Duration( const Duration& dt ) = default;  // trivial copy constructor - allows memcpy and vectorization
 
-        inline Duration& operator= ( const Duration& dt )  // assignment operator
-        {
-            ticks = dt.ticks;
-            return *this;
-        }
+        Duration& operator= ( const Duration& dt ) = default;  // trivial assignment operator
 
 // ------------------------ Time algebra ------------------------------------
 
@@ -154,24 +186,24 @@ namespace Perspective
             return *this;
         }
 
-        inline Duration operator+ ( const Duration& dt ) const { return Duration( ticks + dt.ticks ); }  // addition
-        inline Duration operator- ( const Duration& dt ) const { return Duration( ticks - dt.ticks ); }  // subtraction
-        inline Duration operator* ( const time_real_t& v ) const { return Duration( time_tick_t( time_real_t( ticks ) * v ) ); }  // scaling multiplication
-        inline Duration operator/ ( const time_real_t& v ) const { return Duration( time_tick_t( time_real_t( ticks ) / v ) ); }  // scaling division
+        constexpr Duration operator+ ( const Duration& dt ) const { return Duration( ticks + dt.ticks ); }  // addition
+        constexpr Duration operator- ( const Duration& dt ) const { return Duration( ticks - dt.ticks ); }  // subtraction
+        constexpr Duration operator* ( const time_real_t& v ) const { return Duration( time_tick_t( time_real_t( ticks ) * v ) ); }  // scaling multiplication
+        constexpr Duration operator/ ( const time_real_t& v ) const { return Duration( time_tick_t( time_real_t( ticks ) / v ) ); }  // scaling division
         inline Time operator+ ( const Time& T );  // global time addition - reversed order operands
 
 // --------------------------- Comparisons ----------------------------------
 
-        inline bool operator== ( const Duration& dt ) const { return ticks == dt.ticks; }
-        inline bool operator!= ( const Duration& dt ) const { return ticks != dt.ticks; }
-        inline bool operator> ( const Duration& dt ) const { return ticks > dt.ticks; }
-        inline bool operator< ( const Duration& dt ) const { return ticks < dt.ticks; }
-        inline bool operator>= ( const Duration& dt ) const { return ticks >= dt.ticks; }
-        inline bool operator<= ( const Duration& dt ) const { return ticks <= dt.ticks; }
+        constexpr bool operator== ( const Duration& dt ) const { return ticks == dt.ticks; }
+        constexpr bool operator!= ( const Duration& dt ) const { return ticks != dt.ticks; }
+        constexpr bool operator> ( const Duration& dt ) const { return ticks > dt.ticks; }
+        constexpr bool operator< ( const Duration& dt ) const { return ticks < dt.ticks; }
+        constexpr bool operator>= ( const Duration& dt ) const { return ticks >= dt.ticks; }
+        constexpr bool operator<= ( const Duration& dt ) const { return ticks <= dt.ticks; }
 
 // ------------------------ Various functionality ---------------------------
 
-        inline const time_tick_t& getTicks() const { return ticks; }  // protected data exposition
+        constexpr const time_tick_t& getTicks() const { return ticks; }  // protected data exposition
 
         // time-time division: returns real scaling factor
         inline time_real_t operator/ ( const Duration& dt ) const { return (time_real_t)ticks / (time_real_t)dt.ticks; }
@@ -196,13 +228,15 @@ namespace Perspective
 
     };
 
+    static_assert( std::is_trivially_copyable<Duration>::value, "Duration must stay trivially copyable" );
+
 // ~~~~~~~~~~~~~~~~~~ Duration External functionality ~~~~~~~~~~~~~~~~~~~~~~~
 
-    // constant static Duration instances
-    const static Duration ZERO_Duration = Duration();  // zero-time interval
-    const static Duration SMALLEST_Duration = Duration( 1 );  // smallest possible time interval
-    const static Duration MAX_Duration = Duration( MAX_TICK );  // maximal deltatime value
-    const static Duration MIN_Duration = Duration( MIN_TICK );  // minimal deltatime value
+    // constant Duration instances
+    constexpr Duration ZERO_Duration = Duration();  // zero-time interval
+    constexpr Duration SMALLEST_Duration = Duration( 1 );  // smallest possible time interval
+    constexpr Duration MAX_Duration = Duration( MAX_TICK );  // maximal deltatime value
+    constexpr Duration MIN_Duration = Duration( MIN_TICK );  // minimal deltatime value
 
     inline Duration microsec( const time_tick_t& v ) { return Duration( time_tick_t( v * TICKS_PER_USEC ) ); }
     inline Duration millisec( const time_tick_t& v ) { return Duration( time_tick_t( v * TICKS_PER_MSEC ) ); }
@@ -221,6 +255,48 @@ namespace Perspective
     // program since it has started
     /* inline? */ inline Duration ConsumedTime();  // returns amount of concumed CPU time
 
+    // Returns amount of CPU time consumed by the calling thread. Unlike
+    // ConsumedTime() is not affected by other threads, has OS timer precision
+    // (CLOCK_THREAD_CPUTIME_ID, GetThreadTimes on Windows). A system call,
+    // not for per-item use in hot loops.
+    Duration ThreadCPUTime();  // returns amount of CPU time consumed by current thread
+
+#ifdef PER_TIME_TSC
+    // Runtime check of the TSC calibration. Compares TSC-based time with
+    // steady_clock, refines the TSC frequency using the whole interval since
+    // the startup calibration and republishes it if the error exceeds the
+    // tolerance. Cheap enough to be called once per frame or once per second.
+    // Returns false if the calibration had to be corrected (or TSC is unusable)
+    bool CheckTSCCalibration( const Duration& Tolerance = Duration( TICKS_PER_SEC / 100000 ) );
+
+    // true if ProgramTime() is served by TSC, false on steady_clock fallback
+    bool IsTSCActive();
+#endif
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~ Time source override ~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Interface of a replacement clock for tests and simulations (ManualClock,
+    // VirtualClock in TimeUtils.hpp). While installed it serves ProgramTime(),
+    // SystemTime() and the coarse clocks, so Timer, Repeater, Expectant and
+    // Anisprite follow it, and sleeps of TimeUtils wait on it instead of the
+    // OS. GlobalTime() stays wall time. Costs one predictable branch per
+    // clock reading while not installed.
+    class TimeSource
+    {
+    public:
+        virtual ~TimeSource() = default;
+
+        virtual Duration Now() const = 0;  // current time interval since program start
+        virtual void WaitUntil( const Duration& Deadline ) = 0;  // returns when Now() >= Deadline
+    };
+
+    // installs time source for the whole program, nullptr restores the OS
+    // clock. Returns previously installed source. Source must outlive its use
+    TimeSource* SetTimeSource( TimeSource* Source );
+    inline TimeSource* GetTimeSource();  // installed source or nullptr
+
+    extern std::atomic<TimeSource*> _TimeSourceOverride;  // defined in .cpp, nullptr - OS clock
+
 // ============================== Time =====================================
 
     // Class Time. Represents moment of time, contains ticks since epoch. Can be
@@ -236,27 +312,23 @@ namespace Perspective
         // friends for safety
         friend class Duration;
         friend Duration ProgramTime();
+        friend Duration ProgramTimeCoarse();
         friend Duration ConsumedTime();
         friend Time SystemTime();
         friend Time GlobalTime();
     protected:
         time_tick_t ticks;  // <- main data - amount of ticks since epoch
 
-        static time_t sex;  // totally protected. Temporal variable for conversion to seconds
-        const static time_tick_t start_ticks;  // totally protected. Program start Time (1 sec error possible)
+        static inline time_tick_t start_ticks();  // totally protected. Program start Time (1 sec error possible). Taken on first use
     public:
 
 // -------------------------- Methods --------------------------------------
 
-        Time() : ticks( Time::start_ticks ) {}  // default constructor. Returns program start moment (1 sec error possible). Synonym to StartMoment
-        Time( const time_tick_t& t ) : ticks( t ) {}  // main constructor
-        Time( const Time& T ) : ticks( T.ticks ) {}  // copy constructor
+        Time() : ticks( Time::start_ticks() ) {}  // default constructor. Returns program start moment (1 sec error possible). Steady counterpart of StartMoment()
+        constexpr Time( const time_tick_t& t ) : ticks( t ) {}  // main constructor
+        Time( const Time& T ) = default;  // trivial copy constructor
 
-        inline Time& operator= ( const Time& T )  // assignment operator
-        {
-            ticks = T.ticks;
-            return *this;
-        }
+        Time& operator= ( const Time& T ) = default;  // trivial assignment operator
 
         inline Time& operator+= ( const Duration& dt )  // addition assignment
         {
@@ -291,19 +363,15 @@ namespace Perspective
 
         inline time_t as_time_t() const { return time_t( ticks / TICKS_PER_SEC ); } // C-style time_t conversion
 
-        tm as_tm() const  // C-style struct tm conversion
-        {
-            sex = time_t( ticks / TICKS_PER_SEC );
-            return *localtime( &sex );
-        }
+        tm as_tm() const;  // C-style struct tm conversion (local time). Thread-safe
 
-        char* as_c_str() const  // C-style string of char date-stamp conversion
-        {
-            sex = time_t( ticks / TICKS_PER_SEC );
-            return ctime( &sex );
-        }
+        // C-style string of char date-stamp conversion. Returned buffer is
+        // thread-local and is overwritten by the next call from the same thread
+        char* as_c_str() const;
     };
 
+    static_assert( std::is_trivially_copyable<Time>::value, "Time must stay trivially copyable" );
+
 // ~~~~~~~~~~~~~~~~~~~~~ Time External functionality ~~~~~~~~~~~~~~~~~~~~~~~
 
     inline Time Duration::operator+ ( const Time& T ) { return Time( ticks + T.ticks ); }  // reversed order operands interval addition
@@ -319,15 +387,260 @@ namespace Perspective
     // Returns current moment of time in global time
     /* inline? */ inline Time GlobalTime();  // returns current time moment in global time
 
-    // Moment of time when the program has started. 1 second error may
-    // occur (read 'SystemTime' description)
-    static const Time StartMoment = GlobalTime();
+    // Moment of time when the program has started (the first clock reading
+    // of the process). 1 second error may occur (read 'SystemTime' description)
+    // Was a static constant before: write StartMoment() instead of StartMoment
+    /* inline? */ inline Time StartMoment();
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Coarse clock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Coarse versions of ProgramTime() and SystemTime() for hot paths which
+    // don't need precision: per-entity timestamps, TTL checks, log stamps.
+    // While the coarse ticker runs - a single load of the published value.
+    // Otherwise CLOCK_MONOTONIC_COARSE where available (1-4 ms resolution)
+    // and the precise clock elsewhere.
+    /* inline? */ inline Duration ProgramTimeCoarse();  // coarse time interval since program has started
+    /* inline? */ inline Time SystemTimeCoarse();  // coarse current system time (steady)
+
+    // Starts background thread which publishes SystemTime() every Period.
+    // Resolution of the coarse clock becomes Period plus scheduler latency
+    void StartCoarseTicker( const Duration& Period = millisec( 1 ) );
+    void StopCoarseTicker();  // stops the ticker, coarse clock falls back to OS without going back
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Clock sources ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Policy types for timers and utilities parametrized by a clock. Each
+    // provides static now(), which returns Duration since program start
+    struct ProgramClock { static Duration now() { return ProgramTime(); } };  // precise clock
+    struct CoarseProgramClock { static Duration now() { return ProgramTimeCoarse(); } };  // coarse clock
+    struct ThreadCPUClock { static Duration now() { return ThreadCPUTime(); } };  // CPU time of current thread
+
+    // Frame snapshot clock. Tick() samples ProgramTime() once per frame and
+    // now() returns that sample, so all timers updated within a frame share
+    // a single clock reading and see the same moment. Tick() is called by the
+    // frame loop thread, getters may be used from any thread. Before the
+    // first Tick() returns the moment of program start.
+    class FrameClock
+    {
+    protected:
+        static std::atomic<time_tick_t> NowTicks;  // ProgramTime() at last Tick()
+        static std::atomic<time_tick_t> DeltaTicks;  // time between two last Tick() calls
+        static std::atomic<uint64_t> Frame;  // amount of Tick() calls
+    public:
+        static Duration Tick();  // samples ProgramTime() for the new frame. Returns frame delta
+
+        static inline Duration now() { return Duration( NowTicks.load( std::memory_order_relaxed ) ); }  // snapshot of current frame
+        static inline Duration delta() { return Duration( DeltaTicks.load( std::memory_order_relaxed ) ); }  // length of previous frame
+        static inline uint64_t frame() { return Frame.load( std::memory_order_relaxed ); }  // current frame number
+    };
+
+// ========================= Policy-based timers ============================
+
+    // Non-virtual timers parametrized by a clock source (ProgramClock,
+    // CoarseProgramClock, ThreadCPUClock...). Share Timer's Start-Stop-Get
+    // contract but have no vtable and no temporal members, so calls are
+    // inlined into Expectant, Repeater and user loops. Every method also has
+    // an *At form which takes the current moment from the caller, so a single
+    // clock reading may serve any amount of timers.
+
+    // moment value which marks a stopped StopwatchTimer or ScaledTimer
+    constexpr time_tick_t IDLE_TICK = MIN_TICK;
+
+    // CRTP base: clock-reading forms of the contract on top of Derived *At
+    // methods. Empty, so it adds nothing to the size of Derived.
+    template<class Derived, class ClockT>
+    class _TimerPolicy
+    {
+    public:
+        typedef ClockT clock_type;  // clock source of the timer
+
+        inline void Start( const Duration& dt = ZERO_Duration ) { self().StartAt( ClockT::now(), dt ); }  // begins time calculation. Adds argument to calculated time
+        inline Duration Stop() { return self().StopAt( ClockT::now() ); }  // if WasOn - makes last time update. Stops time calculation, returns calculated time
+        inline Duration Reset( const Duration& dt = ZERO_Duration ) { return self().ResetAt( ClockT::now(), dt ); }  // if WasOn - makes last time update. Stops timer, sets calc time to dt. Returns previously calculated time
+        inline Duration Restart( const Duration& dt = ZERO_Duration ) { return self().RestartAt( ClockT::now(), dt ); }  // if WasOn - makes last time update. Restarts timer, sets calc time to dt. Returns previously calculated time
+        inline Duration Update() { return self().IsOn() ? self().UpdateAt( ClockT::now() ) : self().GetTime(); }  // updates calculated time and returns it. Reads the clock only if IsOn
+
+    private:
+        inline Derived& self() { return static_cast<Derived&>(*this); }
+    };
+
+// ---------------------------- StopwatchTimer ------------------------------
+
+    // the smallest accumulating timer: two Durations, the running state is
+    // encoded in LastT. Size of 16 bytes
+    template<class ClockT = ProgramClock>
+    class StopwatchTimer : public _TimerPolicy<StopwatchTimer<ClockT>, ClockT>
+    {
+    protected:
+        Duration LastT{ IDLE_TICK };  // a moment of last Update event, IDLE_TICK if stopped
+        Duration CountedT{ ZERO_Duration };  // amount of counted time
+    public:
+        inline void StartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            UpdateAt( Now );
+            LastT = Now;
+            CountedT += dt;
+        }
+        inline Duration StopAt( const Duration& Now )
+        {
+            UpdateAt( Now );
+            LastT = Duration( IDLE_TICK );
+            return CountedT;
+        }
+        inline Duration ResetAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = StopAt( Now );
+            CountedT = dt;
+            return Prev;
+        }
+        inline Duration RestartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = ResetAt( Now, dt );
+            LastT = Now;
+            return Prev;
+        }
+        inline Duration UpdateAt( const Duration& Now )
+        {
+            if (IsOn())
+            {
+                CountedT += Now - LastT;
+                LastT = Now;
+            }
+            return CountedT;
+        }
+
+        inline bool IsOn() const { return LastT.getTicks() != IDLE_TICK; }  // true if the timer is counting
+        inline const Duration& GetTime() const { return CountedT; }  // time counted at last update
+    };
+
+// ---------------------------- PausableTimer -------------------------------
+
+    // accumulating timer which also remembers the moment of the last event:
+    // the last update while running or the pause moment while stopped. Size
+    // of 24 bytes
+    template<class ClockT = ProgramClock>
+    class PausableTimer : public _TimerPolicy<PausableTimer<ClockT>, ClockT>
+    {
+    protected:
+        Duration MarkT;  // a moment of last Update event if IsOn, a moment of Stop event otherwise
+        Duration CountedT{ ZERO_Duration };  // amount of counted time
+        bool On = false;  // running state
+    public:
+        PausableTimer() : MarkT( ClockT::now() ) {}  // does NOT start the timer
+        explicit PausableTimer( const Duration& Now ) : MarkT( Now ) {}  // stopped timer with a given Stop moment
+
+        inline void StartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            UpdateAt( Now );
+            MarkT = Now;
+            On = true;
+            CountedT += dt;
+        }
+        inline Duration StopAt( const Duration& Now )
+        {
+            UpdateAt( Now );
+            MarkT = Now;
+            On = false;
+            return CountedT;
+        }
+        inline Duration ResetAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = StopAt( Now );
+            CountedT = dt;
+            return Prev;
+        }
+        inline Duration RestartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = ResetAt( Now, dt );
+            On = true;
+            return Prev;
+        }
+        inline Duration UpdateAt( const Duration& Now )
+        {
+            if (On)
+            {
+                CountedT += Now - MarkT;
+                MarkT = Now;
+            }
+            return CountedT;
+        }
+
+        inline bool IsOn() const { return On; }  // true if the timer is counting
+        inline const Duration& GetTime() const { return CountedT; }  // time counted at last update
+        inline const Duration& GetLast() const { return MarkT; }  // a moment of last Update or Stop event
+    };
+
+// ----------------------------- ScaledTimer --------------------------------
+
+    // accumulating timer which counts clock time multiplied by a scale factor
+    // (slow motion, fast forward, pause by zero scale). Size of 24 bytes
+    template<class ClockT = ProgramClock>
+    class ScaledTimer : public _TimerPolicy<ScaledTimer<ClockT>, ClockT>
+    {
+    protected:
+        Duration LastT{ IDLE_TICK };  // a moment of last Update event, IDLE_TICK if stopped
+        Duration CountedT{ ZERO_Duration };  // amount of counted (scaled) time
+        time_real_t Scale;  // counted time per clock time
+    public:
+        explicit ScaledTimer( const time_real_t& S = 1. ) : Scale( S ) {}  // does NOT start the timer
+
+        inline void StartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            UpdateAt( Now );
+            LastT = Now;
+            CountedT += dt;
+        }
+        inline Duration StopAt( const Duration& Now )
+        {
+            UpdateAt( Now );
+            LastT = Duration( IDLE_TICK );
+            return CountedT;
+        }
+        inline Duration ResetAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = StopAt( Now );
+            CountedT = dt;
+            return Prev;
+        }
+        inline Duration RestartAt( const Duration& Now, const Duration& dt = ZERO_Duration )
+        {
+            Duration Prev = ResetAt( Now, dt );
+            LastT = Now;
+            return Prev;
+        }
+        inline Duration UpdateAt( const Duration& Now )
+        {
+            if (IsOn())
+            {
+                CountedT += (Now - LastT) * Scale;
+                LastT = Now;
+            }
+            return CountedT;
+        }
+
+        // changes the scale. Time before Now is counted with the old scale
+        inline void SetScaleAt( const Duration& Now, const time_real_t& S )
+        {
+            UpdateAt( Now );
+            Scale = S;
+        }
+        inline void SetScale( const time_real_t& S ) { SetScaleAt( IsOn() ? ClockT::now() : LastT, S ); }
+
+        inline bool IsOn() const { return LastT.getTicks() != IDLE_TICK; }  // true if the timer is counting
+        inline const Duration& GetTime() const { return CountedT; }  // scaled time counted at last update
+        inline const time_real_t& GetScale() const { return Scale; }  // current scale
+    };
+
+    static_assert( sizeof( StopwatchTimer<> ) == 2 * sizeof( Duration ), "StopwatchTimer must stay two Durations" );
+    static_assert( sizeof( PausableTimer<> ) <= 3 * sizeof( Duration ), "PausableTimer must fit three Durations" );
+    static_assert( sizeof( ScaledTimer<> ) <= 3 * sizeof( Duration ), "ScaledTimer must fit three Durations" );
 
 // ============================== Timer =====================================
 
     // Class Timer. Virtual class that provides basic time calculation
-    // functionality. Contains 5 Durations (4 accessible) and several methods
-    // for different time management approaches. Time should be an abstract
+    // functionality. Thin virtual adapter over PausableTimer for code which
+    // needs runtime polymorphism (CpuTimer, Anisprite clocks); prefer the
+    // policy-based timers above in hot code. Time should be an abstract
     // algebraic concept. Therefore timer operates with the amounts of time
     // (Durations), but not the moments of time. Time moments are also stored
     // as Durations for memory efficiency and speed.
@@ -335,13 +648,20 @@ namespace Perspective
     class Timer
     {
     protected:
-        Duration StartT{ ZERO_Duration };  // a moment of Start event
-        Duration StopT{ ZERO_Duration };  // a moment of Stop event or PrestartT if timer IsOn (IsOn <=> Stop < Start)
-        Duration CountedT{ ZERO_Duration };  // amount of counted time
-        Duration LastT{ ZERO_Duration };  // a moment of last Update event
+        PausableTimer<ProgramClock> Core;  // counting logic, moments of last Update and Stop events
+        Duration StartT;  // a moment of Start event
+
+        const static Duration PrestartT;  // a moment 1 tick before epoch, Stop moment while IsOn
 
-        Duration TempT{ ZERO_Duration };  // totally protected. Temporal variable
-        const static Duration PrestartT;  // a moment 1 tick before epoch
+        explicit Timer( const Duration& Now );  // constructor for derived timers with another clock
+
+        // implementations of the public methods for a given current moment.
+        // Allow derived timers to reuse the logic with another clock
+        void StartAt( const Duration& Now, const Duration& dt );
+        Duration StopAt( const Duration& Now );
+        Duration ResetAt( const Duration& Now, const Duration& dt );
+        Duration RestartAt( const Duration& Now, const Duration& dt );
+        Duration UpdateAt( const Duration& Now );
     public:
         Timer();  // simple default constructor
         virtual ~Timer() = default;  // virtual destructor
@@ -352,10 +672,47 @@ namespace Perspective
         virtual Duration Restart( const Duration& dt = ZERO_Duration );  // if WasOn - makes last time update. Restarts calculating time. Resets calc time with dt. Returns previously calculated time
         virtual Duration Update();  // updates calculated time and returns it, but only if timer IsOn
 
-        inline const Duration& GetTime() const { return CountedT; }  // simple protected getter
-        inline const Duration& GetLast() const { return LastT; }  // simple protected getter
+        inline bool IsOn() const { return Core.IsOn(); }  // true if the timer is counting
+        inline const Duration& GetTime() const { return Core.GetTime(); }  // simple protected getter
+        inline const Duration& GetLast() const { return Core.GetLast(); }  // simple protected getter
         inline const Duration& GetStart() const { return StartT; }  // simple protected getter
-        inline const Duration& GetStop() const { return StopT; }  // simple protected getter
+        inline const Duration& GetStop() const { return Core.IsOn() ? PrestartT : Core.GetLast(); }  // Stop moment or PrestartT if IsOn
+    };
+
+// ============================== CpuTimer ==================================
+
+    // Class CpuTimer. Timer which counts CPU time consumed by the thread that
+    // uses it (ThreadCPUTime()) instead of wall time, so preemptions and waits
+    // are not counted. Same Start-Stop-Get contract as Timer. All calls must
+    // be made from the same thread.
+    class CpuTimer : public Timer
+    {
+    public:
+        CpuTimer();  // simple default constructor. Does NOT start the timer
+
+        void Start( const Duration& dt = ZERO_Duration ) override;
+        Duration Stop() override;
+        Duration Reset( const Duration& dt = ZERO_Duration ) override;
+        Duration Restart( const Duration& dt = ZERO_Duration ) override;
+        Duration Update() override;
+    };
+
+// ============================= FrameTimer =================================
+
+    // Class FrameTimer. Timer which reads FrameClock snapshot instead of the
+    // clock, so any amount of FrameTimers (or Anisprites sharing one) costs
+    // no clock readings and stays consistent within a frame. Same Start-Stop-
+    // Get contract as Timer.
+    class FrameTimer : public Timer
+    {
+    public:
+        FrameTimer();  // simple default constructor. Does NOT start the timer
+
+        void Start( const Duration& dt = ZERO_Duration ) override;
+        Duration Stop() override;
+        Duration Reset( const Duration& dt = ZERO_Duration ) override;
+        Duration Restart( const Duration& dt = ZERO_Duration ) override;
+        Duration Update() override;
     };
 }
 
@@ -370,35 +727,49 @@ namespace Perspective
 
 #ifdef PER_TIME_WINDOWS_QPC
 
+    // program start anchors of the performance counter
     struct _win_QPC_local
     {
-        __int64 _tempTicks;  // temporal variable for ticks per second
-        __int64 _startTicks;  // local variable for program time evaluation
-        __int64 _startTimeTicks;  // local variable for ticks of start time.
-        __int64 _startShifted;  // 
-        __int64 _startTime;  //
+        __int64 Frequency;  // ticks per second
+        __int64 StartTicks;  // counter at program start
+        __int64 StartTimeTicks;  // ticks of start time (time() based)
 
         _win_QPC_local()
         {
-            if (!QueryPerformanceFrequency( (LARGE_INTEGER*)&_tempTicks ))
+            if (!QueryPerformanceFrequency( (LARGE_INTEGER*)&Frequency ))
                 throw ("Performance counters not supported");
-            QueryPerformanceCounter( (LARGE_INTEGER*)&_startTicks );
-            _startTime = time( 0 );
-            _startTimeTicks = _startTime * _tempTicks;
-            _startShifted = _startTicks - _startTicks % _tempTicks;
+            QueryPerformanceCounter( (LARGE_INTEGER*)&StartTicks );
+            StartTimeTicks = time( 0 ) * Frequency;
         }
-    } _QPC_local;  // temporal instance for initializations
+    };
 
-    // period initialization
-    const time_tick_t TICKS_PER_SEC = _QPC_local._tempTicks;
+    // single instance initialized by the first clock reading (thread-safe
+    // function-local static), so no TU depends on initialization order
+    inline const _win_QPC_local& _QPC_context()
+    {
+        static const _win_QPC_local Context;
+        return Context;
+    }
+
+    inline __int64 _QPC_now()
+    {
+        __int64 Ticks;
+        QueryPerformanceCounter( (LARGE_INTEGER*)&Ticks );
+        return Ticks;
+    }
+
+    time_tick_t Time::start_ticks() { return _QPC_context().StartTimeTicks; }
 
 // ------------------------------ Duration ---------------------------------
 
     // implementation of main function. Actually must be inlined but I doubt.
     Duration ProgramTime()
     {
-        QueryPerformanceCounter( (LARGE_INTEGER*)&_QPC_local._tempTicks );
-        return Duration( _QPC_local._tempTicks - _QPC_local._startTicks );
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Source->Now();
+        __int64 Start = _QPC_context().StartTicks;  // the first call takes it: read before the clock
+        return Duration( _QPC_now() - Start );
     }
 
     // returns total approxymate amount of consumed by all trhreads CPU time
@@ -412,8 +783,11 @@ namespace Perspective
     // returns current moment of system time
     Time SystemTime()
     {
-        QueryPerformanceCounter( (LARGE_INTEGER*)&_QPC_local._tempTicks );
-        return Time( _QPC_local._startTimeTicks + _QPC_local._tempTicks - _QPC_local._startTicks );
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Time( Time::start_ticks() + Source->Now().getTicks() );
+        const _win_QPC_local& Context = _QPC_context();
+        return Time( Context.StartTimeTicks + _QPC_now() - Context.StartTicks );
     }
 
     // TODO: add system-not-steady implementation
@@ -421,20 +795,126 @@ namespace Perspective
     // returns current moment of global time
     Time GlobalTime()
     {
-        QueryPerformanceCounter( (LARGE_INTEGER*)&_QPC_local._tempTicks );
-        return Time( _QPC_local._startTimeTicks + _QPC_local._tempTicks - _QPC_local._startTicks );
+        const _win_QPC_local& Context = _QPC_context();
+        return Time( Context.StartTimeTicks + _QPC_now() - Context.StartTicks );
     }
 
 
 
+    // GlobalTime() is SystemTime() with this backend
+    Time StartMoment() { return Time( Time::start_ticks() ); }
+
+#elif defined(PER_TIME_TSC)
+
+    // Single calibration snapshot. Maps TSC cycles onto steady_clock ticks.
+    // A correction is slewed out during the first SlewCycles after the base,
+    // the true rate applies afterwards:
+    // ticks = BaseTicks + ((cycles - BaseCycles) * SlewMult) >> _TSC_SHIFT  within the slew window,
+    // ticks = BaseTicks + SlewTicks + ((cycles - BaseCycles - SlewCycles) * Mult) >> _TSC_SHIFT  after it
+    struct _TSC_calibration
+    {
+        uint64_t BaseCycles;  // TSC value at the anchor point
+        time_tick_t BaseTicks;  // steady_clock ticks at the anchor point
+        int64_t Mult;  // fixed-point amount of ticks per cycle
+        uint64_t SlewCycles;  // length of the slew window, 0 - no slew
+        time_tick_t SlewTicks;  // ticks counted during the slew window
+        int64_t SlewMult;  // rate within the slew window
+    };
+
+    constexpr unsigned _TSC_SHIFT = 32;  // fractional bits of _TSC_calibration::Mult
+
+    // calibration published under a seqlock: readers retry if the single
+    // writer (first readings, CheckTSCCalibration) has changed it meanwhile
+    struct _TSC_local
+    {
+        std::atomic<uint32_t> Seq;  // 0 - not calibrated (steady_clock fallback), odd - being written
+        std::atomic<uint64_t> BaseCycles;
+        std::atomic<time_tick_t> BaseTicks;
+        std::atomic<int64_t> Mult;
+        std::atomic<uint64_t> SlewCycles;
+        std::atomic<time_tick_t> SlewTicks;
+        std::atomic<int64_t> SlewMult;
+        _TSC_calibration Origin;  // startup sample, baseline for frequency refinement. Writer only
+    };
+    extern _TSC_local _TSC_state;  // defined in .cpp, calibrated by the first readings
+
+    // steady_clock reading while TSC is not calibrated. The first call takes
+    // the calibration origin, a call 2 ms later publishes the calibration:
+    // no startup cost and no spinning
+    time_tick_t _TSC_fallback();
+
+    inline uint64_t _TSC_read()
+    {
+#ifdef PER_TIME_TSC_AVAILABLE
+        return __rdtsc();  // not serializing - enough for timestamps, cheaper than rdtscp
+#else
+        return 0;
+#endif
+    }
+
+    // (Delta * Mult) >> _TSC_SHIFT without 64-bit overflow
+    inline time_tick_t _TSC_scale( int64_t Delta, int64_t Mult )
+    {
+#if defined(_MSC_VER)
+        __int64 High;
+        unsigned __int64 Low = (unsigned __int64)_mul128( Delta, Mult, &High );
+        return (time_tick_t)((Low >> _TSC_SHIFT) | ((unsigned __int64)High << (64 - _TSC_SHIFT)));
 #else
+        return (time_tick_t)(((__int128)Delta * Mult) >> _TSC_SHIFT);
+#endif
+    }
+
+    // consistent copy of the published calibration. Returns false if TSC is not calibrated
+    inline bool _TSC_load( _TSC_calibration& C )
+    {
+        for (;;)
+        {
+            uint32_t Seq = _TSC_state.Seq.load( std::memory_order_acquire );
+            if (!Seq)
+                return false;
+            if (Seq & 1)
+                continue;  // the writer is in the middle
+            C.BaseCycles = _TSC_state.BaseCycles.load( std::memory_order_relaxed );
+            C.BaseTicks = _TSC_state.BaseTicks.load( std::memory_order_relaxed );
+            C.Mult = _TSC_state.Mult.load( std::memory_order_relaxed );
+            C.SlewCycles = _TSC_state.SlewCycles.load( std::memory_order_relaxed );
+            C.SlewTicks = _TSC_state.SlewTicks.load( std::memory_order_relaxed );
+            C.SlewMult = _TSC_state.SlewMult.load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if (_TSC_state.Seq.load( std::memory_order_relaxed ) == Seq)
+                return true;
+        }
+    }
+
+    // ticks of a TSC value by calibration C
+    inline time_tick_t _TSC_convert( const _TSC_calibration& C, uint64_t Cycles )
+    {
+        int64_t Delta = (int64_t)(Cycles - C.BaseCycles);
+        if (Delta < (int64_t)C.SlewCycles)
+            return C.BaseTicks + _TSC_scale( Delta, C.SlewMult );
+        return C.BaseTicks + C.SlewTicks + _TSC_scale( Delta - (int64_t)C.SlewCycles, C.Mult );
+    }
+
+    // current steady_clock-compatible ticks. Falls back to steady_clock until
+    // calibrated and whenever TSC is not invariant
+    inline time_tick_t _TSC_now()
+    {
+        _TSC_calibration C;
+        if (!_TSC_load( C ))
+            return _TSC_fallback();
+        return _TSC_convert( C, _TSC_read() );
+    }
 
 // ------------------------------ Duration ---------------------------------
 
     // implementation of main function. Actually must be inlined but I doubt.
     Duration ProgramTime()
     {
-        return Duration( std::chrono::steady_clock::now().time_since_epoch().count() - Time::start_ticks );
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Source->Now();
+        time_tick_t Start = Time::start_ticks();  // the first call takes it: read before the clock
+        return Duration( _TSC_now() - Start );
     }
 
     // returns total approxymate amount of consumed by all trhreads CPU time
@@ -448,6 +928,47 @@ namespace Perspective
     // returns current moment of system time
     Time SystemTime()
     {
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Time( Time::start_ticks() + Source->Now().getTicks() );
+        return Time( _TSC_now() );
+    }
+
+    // TODO: add system-not-steady implementation
+    // returns current moment of global time
+    Time GlobalTime()
+    {
+        return Time( std::chrono::system_clock::now().time_since_epoch().count() );
+    }
+
+#else
+
+// ------------------------------ Duration ---------------------------------
+
+    // implementation of main function. Actually must be inlined but I doubt.
+    Duration ProgramTime()
+    {
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Source->Now();
+        time_tick_t Start = Time::start_ticks();  // the first call takes it: read before the clock
+        return Duration( std::chrono::steady_clock::now().time_since_epoch().count() - Start );
+    }
+
+    // returns total approxymate amount of consumed by all trhreads CPU time
+    Duration ConsumedTime()
+    {
+        return Duration( (time_tick_t)clock() * TICKS_PER_CLOCK );
+    }
+
+// -------------------------------- Time ------------------------------------
+
+    // returns current moment of system time
+    Time SystemTime()
+    {
+        TimeSource* Source = _TimeSourceOverride.load( std::memory_order_acquire );
+        if (Source)
+            return Time( Time::start_ticks() + Source->Now().getTicks() );
         return Time( std::chrono::steady_clock::now().time_since_epoch().count() );
     }
 
@@ -459,4 +980,78 @@ namespace Perspective
     }
 
 #endif
+
+// ----------------------- Start anchors (chrono, TSC) ----------------------
+
+#ifndef PER_TIME_WINDOWS_QPC
+    // Program start anchors. Constant-initialized (zero - not taken yet) and
+    // filled by the first clock reading of the process, so they don't depend
+    // on static initialization order and have a single definition
+    struct _time_context
+    {
+        std::atomic<time_tick_t> StartTicks;  // SystemTime() ticks at program start
+        std::atomic<time_tick_t> StartGlobalTicks;  // GlobalTime() ticks at program start
+    };
+    extern _time_context _TimeContext;  // defined in .cpp
+    time_tick_t _TimeContextInit();  // takes the anchors once. Returns StartTicks
+
+    time_tick_t Time::start_ticks()
+    {
+        time_tick_t Ticks = _TimeContext.StartTicks.load( std::memory_order_relaxed );
+        return Ticks ? Ticks : _TimeContextInit();
+    }
+
+    Time StartMoment()
+    {
+        time_tick_t Ticks = _TimeContext.StartGlobalTicks.load( std::memory_order_acquire );
+        if (!Ticks)
+        {
+            _TimeContextInit();
+            Ticks = _TimeContext.StartGlobalTicks.load( std::memory_order_acquire );
+        }
+        return Time( Ticks );
+    }
+#endif
+
+// ------------------------- Coarse clock (OS independant) -------------------
+
+    // SystemTime() ticks published by the coarse ticker. Occupies a whole cache
+    // line, so the ticker never invalidates lines with readers' data
+    struct alignas( 64 ) _coarse_published
+    {
+        std::atomic<time_tick_t> Ticks;  // 0 - ticker is not running
+        std::atomic<time_tick_t> Floor;  // the last published value after the ticker stops: OS coarse clock lags it
+    };
+    extern _coarse_published _CoarseNow;  // defined in .cpp
+
+    // returns coarse current moment of system time
+    Time SystemTimeCoarse()
+    {
+        if (_TimeSourceOverride.load( std::memory_order_acquire ))
+            return SystemTime();
+        time_tick_t Published = _CoarseNow.Ticks.load( std::memory_order_relaxed );
+        if (Published)
+            return Time( Published );
+#if defined(CLOCK_MONOTONIC_COARSE) && !defined(PER_TIME_WINDOWS_QPC)
+        timespec Ts;  // same epoch as steady_clock
+        clock_gettime( CLOCK_MONOTONIC_COARSE, &Ts );
+        time_tick_t Os = (time_tick_t)Ts.tv_sec * TICKS_PER_SEC + (time_tick_t)Ts.tv_nsec * TICKS_PER_SEC / 1000000000;
+        time_tick_t Floor = _CoarseNow.Floor.load( std::memory_order_relaxed );
+        return Time( Os > Floor ? Os : Floor );  // never behind a stopped ticker
+#else
+        return SystemTime();
+#endif
+    }
+
+    // returns coarse time interval since program has started
+    Duration ProgramTimeCoarse()
+    {
+        time_tick_t Start = Time::start_ticks();  // the first call takes it: read before the clock
+        time_tick_t Now = SystemTimeCoarse().ticks;
+        return Duration( Now > Start ? Now - Start : 0 );  // coarse clock may lag the precise start anchor
+    }
+
+// ------------------------- Time source override ---------------------------
+
+    TimeSource* GetTimeSource() { return _TimeSourceOverride.load( std::memory_order_acquire ); }
 }
@@ -14,6 +14,9 @@
 #include "CoreTypes.hpp"
 #include "Timer.hpp"
 #include "TimeUtils.hpp"
+#include "FixedStepLoop.hpp"
+#include "FrameWatchdog.hpp"
+#include "FrameGraph.hpp"
 
 //------------------------------- MAIN -------------------------------
 using namespace Perspective;
@@ -25,28 +28,55 @@ int main()
     sf::RenderWindow window( sf::VideoMode( 200, 200 ), "SFML works!" );
     sf::CircleShape shape( 100.f );
     shape.setFillColor( sf::Color::Green );
-    sf::Clock clock;
-    sf::Time time, sec = sf::seconds( 1. );
 
-    while (window.isOpen())  // <- Actually the main loop
+    // simulation at 60 Hz, rendering every frame (throttled by display)
+    FixedStepLoop loop( seconds( 1 ) / 60. );
+    Duration nextReport = seconds( 1 );
+
+    // simulation systems, ordered by the resources they access
+    JobSystem jobs;
+    FrameGraph simulation( jobs );
+    FrameGraph::ResourceId console = simulation.AddResource( "Console" );
+    simulation.AddNode( "TimeReport", [&]
     {
-        sf::Event event;
-        while (window.pollEvent( event ))
+        if (loop.GetSimTime() >= nextReport)
         {
-            if (event.type == sf::Event::Closed)
-                window.close();
+            nextReport += seconds( 1 );
+            int sec = (int)loop.GetSimTime().asSec();
+            printf( "Time: %d:%d\n", sec / 60, sec % 60 );
         }
-        sf::Time t = clock.getElapsedTime();
-        if (t > sec + time)
+    }, {}, { console } );
+
+    // reports frames longer than 100 ms
+    FrameWatchdog watchdog( millisec( 100 ) );
+    watchdog.Start();
+
+    loop.Run(
+        [&]( const Duration& )  // simulation step
         {
-            time = t;
-            printf( "Time: %d:%d\n", ((int)time.asSeconds()) / 60, (int)time.asSeconds() );
-        }
+            simulation.Execute();
+        },
+        [&]( double )  // render with interpolation alpha
+        {
+            FrameClock::Tick();  // single clock reading for all frame timers
+            watchdog.Heartbeat( FrameClock::now() );
+
+            sf::Event event;
+            while (window.pollEvent( event ))
+            {
+                if (event.type == sf::Event::Closed)
+                {
+                    window.close();
+                    loop.Stop();
+                }
+            }
 
-        window.clear();
-        window.draw( shape );
-        window.display();
-    }
+            window.clear();
+            window.draw( shape );
+            window.display();
+        } );
 
+    watchdog.Stop();
+    watchdog.WriteReports( std::cout );
     return 0;
 }
\ No newline at end of file
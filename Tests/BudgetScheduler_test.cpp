@@ -0,0 +1,73 @@
+/*
+ * Simple test for TimeUtils.hpp::BudgetScheduler - 200 ms of loading work
+ * spread over frames with 4 ms budget, progress reports, cancellation and
+ * items waiting for data
+ */
+
+#include <iostream>
+using namespace std;
+
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+// busy work of a given length
+void work( const Duration& d )
+{
+    ElementaryTimer t;
+    while (t.GetTime() < d)
+        ;
+}
+
+// loader of Chunks pieces of 250 us each, yields when the budget is over
+BudgetScheduler::WorkItem loader( int chunks, int* done )
+{
+    return [chunks, done]( BudgetScheduler::Slice& s ) mutable
+    {
+        while (*done < chunks)
+        {
+            work( microsec( 250 ) );
+            ++*done;
+            s.SetProgress( float( *done ) / chunks );
+            if (s.Expired())
+                break;
+        }
+        return *done == chunks;
+    };
+}
+
+int main()
+{
+    BudgetScheduler scheduler;
+    int texture = 0, animation = 0, script = 0;
+    BudgetScheduler::TaskId t = scheduler.Submit( loader( 400, &texture ) );  // 100 ms
+    BudgetScheduler::TaskId a = scheduler.Submit( loader( 400, &animation ) );  // 100 ms
+    BudgetScheduler::TaskId s = scheduler.Submit( loader( 4000, &script ) );  // 1 s, canceled on the way
+
+    int frames = 0;
+    Duration worst = ZERO_Duration;
+    while (scheduler.Size() && frames < 1000)
+    {
+        scheduler.Run( millisec( 4 ) );
+        frames++;
+        worst = max( worst, scheduler.GetLastUsed() );
+        if (frames == 10)
+            cout << "progress at frame 10: " << scheduler.GetProgress( t ) << " " << scheduler.GetProgress( a ) << " " << scheduler.GetProgress( s ) << endl;
+        if (frames == 20)
+            cout << "script canceled: " << scheduler.Cancel( s ) << " (expected 1)" << endl;
+    }
+    cout << "frames: " << frames << " (expected ~50)\tworst frame: " << worst.asMilliSec() << " ms (expected ~4.25)" << endl;
+    cout << "texture: " << texture << " animation: " << animation << " (expected 400 400)\tscript stopped at: " << script << endl;
+    cout << "pending: " << scheduler.IsPending( t ) << scheduler.IsPending( a ) << scheduler.IsPending( s ) << " (expected 000)" << endl;
+    cout << "cancel finished: " << scheduler.Cancel( t ) << " (expected 0)" << endl;
+
+    // items waiting for a file read do nothing: Run leaves after one round
+    int calls = 0;
+    bool ready = false;
+    for (int i = 0; i < 3; i++)
+        scheduler.Submit( [&]( BudgetScheduler::Slice& s ) { calls++; if (!ready) s.Idle(); return ready; } );
+    scheduler.Run( millisec( 4 ) );
+    cout << "idle items: calls " << calls << " (expected 3)\tused: " << scheduler.GetLastUsed().asMilliSec() << " ms (expected ~0)" << endl;
+    ready = true;
+    cout << "finished when ready: " << scheduler.Run( millisec( 4 ) ) << " (expected 3)" << endl;
+    return 0;
+}
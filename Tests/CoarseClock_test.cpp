@@ -0,0 +1,66 @@
+/*
+ * Simple test for the coarse clock of Timer.hpp - ProgramTimeCoarse() is
+ * monotonic, lags ProgramTime() by at most a ticker period, the ticker thread
+ * publishes new values and timers run on it through the clock parameter
+ */
+
+#include <iostream>
+#include <algorithm>
+using namespace std;
+
+#include "Timer.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+// reads both clocks for Span: coarse going backwards, coarse ahead of the
+// precise clock read after it, the largest lag and distinct coarse values
+static void Probe( const char* Name, const Duration& Span, const Duration& Expected )
+{
+    int backwards = 0, ahead = 0, distinct = 0;
+    Duration maxLag, prev = ProgramTimeCoarse();
+    Duration end = ProgramTime() + Span;
+    for (Duration now = ProgramTime(); now < end; )
+    {
+        Duration coarse = ProgramTimeCoarse();
+        now = ProgramTime();
+        backwards += coarse < prev;
+        ahead += coarse > now;
+        distinct += coarse != prev;
+        maxLag = max( maxLag, now - coarse );
+        prev = coarse;
+    }
+    cout << Name << ": backwards " << backwards << ", ahead of ProgramTime " << ahead << " (expected 0 0), "
+        << "max lag " << maxLag.asMilliSec() << " ms (expected < ~" << Expected.asMilliSec() << "), "
+        << distinct << " updates in " << Span.asMilliSec() << " ms" << endl;
+}
+
+int main()
+{
+    // OS coarse clock without the ticker
+    Probe( "OS coarse clock", millisec( 100 ), millisec( 8 ) );  // 1-4 ms steps, read up to a step late
+
+    // the ticker publishes a new value every period
+    StartCoarseTicker( millisec( 1 ) );
+    Sleep( millisec( 10 ) );  // the first publications
+    Probe( "1 ms ticker", millisec( 100 ), millisec( 2 ) );  // period plus scheduler latency
+
+    Duration before = ProgramTimeCoarse();
+    Sleep( millisec( 50 ) );
+    cout << "ticker published over 50 ms sleep: " << (ProgramTimeCoarse() - before).asMilliSec() << " ms (expected ~50)" << endl;
+
+    // timers read the coarse clock through their clock parameter
+    StopwatchTimer<CoarseProgramClock> coarseTimer;
+    StopwatchTimer<> preciseTimer;
+    coarseTimer.Start();
+    preciseTimer.Start();
+    Sleep( millisec( 50 ) );
+    cout << "coarse timer: " << coarseTimer.Stop().asMilliSec() << " ms, precise: " << preciseTimer.Stop().asMilliSec() << " ms (expected within ~1 ms)" << endl;
+
+    // stopped ticker falls back to the OS coarse clock, still monotonic
+    Duration last = ProgramTimeCoarse();
+    StopCoarseTicker();
+    Duration after = ProgramTimeCoarse();
+    cout << "after StopCoarseTicker: backwards " << (after < last) << " (expected 0)" << endl;
+    Probe( "OS coarse clock again", millisec( 50 ), millisec( 8 ) );
+    return 0;
+}
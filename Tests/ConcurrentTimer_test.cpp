@@ -0,0 +1,58 @@
+/*
+ * Simple test for TimeUtils.hpp::ConcurrentTimer - one writer, several readers.
+ * The writer publishes moments tied to each other, so a snapshot mixing two
+ * publications breaks the relation
+ */
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+ConcurrentTimer<> CT;
+std::atomic<bool> running{ true };
+
+// counted time of the cycle started at Start
+time_tick_t length( const Duration& Start ) { return Start.getTicks() / 1000 % 997 + 1; }
+
+void reader( int id )
+{
+    long long reads = 0, errors = 0;
+    while (running.load( std::memory_order_relaxed ))
+    {
+        ConcurrentTimer<>::Snapshot s = CT.Read();
+        time_tick_t k = length( s.Start );
+        if (s.IsOn() && s.Counted.getTicks() != 0 && s.Counted.getTicks() != k)  // just restarted or updated
+            errors++;
+        if (!s.IsOn() && (s.Counted.getTicks() != k || s.Stop != s.Start + s.Counted))  // stopped after the update
+            errors++;
+        reads++;
+    }
+    cout << id << "\treads: " << reads << "\terrors: " << errors << " (expected 0)" << endl;
+}
+
+int main()
+{
+    CT.StopAt( Duration( length( ZERO_Duration ) ) );  // the initial state satisfies the relation
+    std::thread r1( reader, 1 );
+    std::thread r2( reader, 2 );
+
+    // cycle i: restart at i * 1000, update and stop at Start + length
+    Duration end = ProgramTime() + seconds( 1 );
+    long long cycles = 0;
+    for (time_tick_t i = 1; ProgramTime() < end; i++, cycles++)
+    {
+        Duration start( i * 1000 );
+        CT.RestartAt( start );
+        CT.UpdateAt( start + Duration( length( start ) ) );
+        CT.StopAt( start + Duration( length( start ) ) );
+    }
+    running = false;
+    r1.join();
+    r2.join();
+
+    cout << "cycles: " << cycles << "\tlast counted: " << CT.GetTime().getTicks() << " ticks" << endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Simple test for ThreadCPUTime() and CpuTimer of Timer.hpp - sleeping adds
+ * no CPU time, a busy loop adds about its wall time, work of other threads
+ * is not counted
+ */
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include "Timer.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+// spins for Wall of ProgramTime(). Returns the spin count, so it isn't optimized out
+static long Busy( const Duration& Wall )
+{
+    long spins = 0;
+    Duration end = ProgramTime() + Wall;
+    while (ProgramTime() < end)
+        spins++;
+    return spins;
+}
+
+int main()
+{
+    // sleeping thread consumes no CPU
+    Duration cpu = ThreadCPUTime();
+    Sleep( millisec( 100 ) );
+    cout << "CPU during 100 ms sleep: " << (ThreadCPUTime() - cpu).asMilliSec() << " ms (expected ~0)" << endl;
+
+    // busy loop consumes about its wall time (less if the core is shared)
+    cpu = ThreadCPUTime();
+    long spins = Busy( millisec( 100 ) );
+    cout << "CPU during 100 ms busy loop: " << (ThreadCPUTime() - cpu).asMilliSec() << " ms (expected ~100), spins " << spins << endl;
+
+    // CpuTimer accumulates busy time only, pauses like Timer
+    CpuTimer timer;
+    timer.Start();
+    Busy( millisec( 50 ) );
+    Sleep( millisec( 50 ) );
+    cout << "CpuTimer over 50 ms busy + 50 ms sleep: " << timer.Update().asMilliSec() << " ms (expected ~50)" << endl;
+    Duration stopped = timer.Stop();
+    Busy( millisec( 50 ) );
+    cout << "stopped CpuTimer after 50 ms busy: " << timer.Update().asMilliSec() << " ms (expected " << stopped.asMilliSec() << ")" << endl;
+    timer.Start();
+    Busy( millisec( 50 ) );
+    cout << "resumed CpuTimer after 50 ms busy: " << timer.Stop().asMilliSec() << " ms (expected ~100)" << endl;
+
+    // CPU time is per thread: a busy neighbour is not counted
+    cpu = ThreadCPUTime();
+    thread neighbour( [] { Busy( millisec( 100 ) ); } );
+    neighbour.join();
+    cout << "CPU while another thread was busy 100 ms: " << (ThreadCPUTime() - cpu).asMilliSec() << " ms (expected ~0)" << endl;
+
+    // policy timer on the same clock
+    StopwatchTimer<ThreadCPUClock> policy;
+    policy.Start();
+    Busy( millisec( 50 ) );
+    Sleep( millisec( 50 ) );
+    cout << "StopwatchTimer<ThreadCPUClock> over 50 ms busy + 50 ms sleep: " << policy.Stop().asMilliSec() << " ms (expected ~50)" << endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Simple test for FixedStepLoop.hpp - accumulator and spiral of death cap
+ * with given frame intervals, then real headless and rendering runs
+ */
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include "FixedStepLoop.hpp"
+using namespace Perspective;
+
+int main()
+{
+    // virtual frames: 2.5 steps of real time per frame
+    FixedStepLoop L( millisec( 10 ) );
+    int steps = 0;
+    for (int i = 0; i < 4; i++)
+        L.Advance( millisec( 25 ), [&]( const Duration& ) { steps++; } );
+    cout << "steps: " << steps << " (expected 10)\talpha: " << L.GetAlpha() << " (expected 0)" << endl;
+    L.Advance( millisec( 13 ), [&]( const Duration& ) { steps++; } );
+    cout << "steps: " << steps << " (expected 11)\talpha: " << L.GetAlpha() << " (expected 0.3)" << endl;
+
+    // 1 second hitch is capped at 8 steps
+    unsigned n = L.Advance( seconds( 1 ), [&]( const Duration& ) { steps++; } );
+    cout << "hitch steps: " << n << " (expected 8)\tdropped: " << L.GetDropped().asMilliSec() << " ms (expected 920)" << endl;
+    cout << "sim time: " << L.GetSimTime().asMilliSec() << " ms (expected 190)" << endl;
+
+    // headless server at 100 Hz for 0.5 second
+    FixedStepLoop S( millisec( 10 ) );
+    thread stopper( [&S] { Sleep( millisec( 500 ) ); S.Stop(); } );
+    S.RunHeadless( []( const Duration& ) {} );
+    stopper.join();
+    cout << "headless steps: " << S.GetStepCount() << " (expected ~50)" << endl;
+
+    // client: 100 Hz simulation, ~30 Hz rendering for 0.5 second
+    FixedStepLoop C( millisec( 10 ), millisec( 33 ) );
+    double alphaMin = 1, alphaMax = 0;
+    Duration start = ProgramTime();
+    C.Run( [&]( const Duration& ) { if (ProgramTime() - start > millisec( 500 )) C.Stop(); },
+        [&]( double a ) { alphaMin = min( alphaMin, a ); alphaMax = max( alphaMax, a ); } );
+    cout << "client steps: " << C.GetStepCount() << " (expected ~50)\trenders: " << C.GetRenderCount() << " (expected ~15)" << endl;
+    cout << "alpha range: " << alphaMin << " - " << alphaMax << " (expected within [0, 1))" << endl;
+    return 0;
+}
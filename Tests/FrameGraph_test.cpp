@@ -0,0 +1,78 @@
+/*
+ * Simple test for FrameGraph.hpp - dependencies derived from resource
+ * access, order of nodes over many frames, concurrency of independent
+ * systems and the critical path
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+using namespace std;
+
+#include "FrameGraph.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+atomic<int> sequence{ 0 };
+int stamp[5];  // sequence number of every node in the current frame
+
+// simulated system: waits instead of computing, so it overlaps even on a single core
+void work( int node, int ms )
+{
+    stamp[node] = sequence++;
+    Sleep( millisec( ms ) );
+}
+
+int main()
+{
+    JobSystem jobs( max( 4u, thread::hardware_concurrency() ) );
+    FrameGraph graph( jobs );
+
+    FrameGraph::ResourceId events = graph.AddResource( "InputEvents" );
+    FrameGraph::ResourceId world = graph.AddResource( "World" );
+    FrameGraph::ResourceId poses = graph.AddResource( "Poses" );
+    FrameGraph::ResourceId visible = graph.AddResource( "VisibleSet" );
+    FrameGraph::ResourceId drawList = graph.AddResource( "DrawList" );
+
+    FrameGraph::NodeId input = graph.AddNode( "Input", [] { work( 0, 2 ); }, {}, { events } );
+    FrameGraph::NodeId sim = graph.AddNode( "Simulation", [] { work( 1, 5 ); }, { events }, { world } );
+    FrameGraph::NodeId anim = graph.AddNode( "Animation", [] { work( 2, 8 ); }, { world }, { poses } );
+    FrameGraph::NodeId cull = graph.AddNode( "Culling", [] { work( 3, 4 ); }, { world }, { visible } );
+    FrameGraph::NodeId prep = graph.AddNode( "RenderPrep", [] { work( 4, 3 ); }, { poses, visible }, { drawList } );
+
+    graph.Compile();
+    cout << "nodes: " << graph.GetNodeCount() << ", edges: " << graph.GetEdgeCount() << " (expected 5)" << endl;
+    cout << "RenderPrep waits for:";
+    for (FrameGraph::NodeId d : graph.GetDependencies( prep ))
+        cout << " " << graph.GetNodeName( d );
+    cout << " (expected Animation Culling)" << endl;
+    cout << "Culling waits for Animation: " << (graph.GetDependencies( cull ).size() != 1) << " (expected 0)" << endl;
+
+    int wrongOrder = 0;
+    for (int frame = 0; frame < 50; frame++)
+    {
+        graph.Execute();
+        wrongOrder += !(stamp[input] < stamp[sim] && stamp[sim] < stamp[anim] && stamp[sim] < stamp[cull]
+            && stamp[anim] < stamp[prep] && stamp[cull] < stamp[prep]);
+    }
+    cout << "frames in wrong order: " << wrongOrder << " (expected 0)" << endl;
+
+    Duration serial = ZERO_Duration;
+    for (FrameGraph::NodeId n = 0; n < graph.GetNodeCount(); n++)
+        serial += graph.GetNodeTime( n );
+    cout << "frame " << graph.GetFrameTime().asMilliSec() << " ms, serial sum " << serial.asMilliSec()
+        << " ms, critical path " << graph.GetCriticalPathTime().asMilliSec() << " ms (expected ~18 of ~22)" << endl;
+    cout << "critical path:";
+    for (FrameGraph::NodeId n : graph.GetCriticalPath())
+        cout << " " << graph.GetNodeName( n );
+    cout << " (expected Input Simulation Animation RenderPrep)" << endl;
+    cout << "Culling overlaps Animation: " << (graph.GetNodeStart( cull ) < graph.GetNodeStart( anim ) + graph.GetNodeTime( anim )
+        && graph.GetNodeStart( anim ) < graph.GetNodeStart( cull ) + graph.GetNodeTime( cull )) << " (expected 1)" << endl;
+
+    // the graph is rebuilt after a new system is added
+    atomic<int> audioRuns{ 0 };
+    graph.AddNode( "Audio", [&] { audioRuns++; }, { world }, {} );
+    graph.Execute();
+    cout << "edges with audio: " << graph.GetEdgeCount() << " (expected 6), audio runs: " << audioRuns << endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Simple test for FrameWatchdog.hpp - normal frames, a stall inside nested
+ * profiling zones, disarmed pauses and the report output
+ */
+
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+#include "FrameWatchdog.hpp"
+using namespace Perspective;
+
+void onStall( const StallReport& r, void* user )
+{
+    ++*(int*)user;
+    cout << "handler: stall detected after " << r.Length.asMilliSec() << " ms, depth " << r.Depth << endl;
+}
+
+void loadMesh()
+{
+    PROFILE_SCOPE( "LoadMesh" );
+    Sleep( millisec( 300 ) );  // hitch
+}
+
+int main()
+{
+    ProfileThreadInit( "main" );
+    FrameWatchdog watchdog( millisec( 100 ), 4 );
+    int handled = 0;
+    watchdog.SetHandler( onStall, &handled );
+    watchdog.Start();
+
+    // 30 normal frames of ~10 ms
+    for (int frame = 0; frame < 30; frame++)
+    {
+        watchdog.Heartbeat();
+        PROFILE_SCOPE( "Frame" );
+        Sleep( millisec( 10 ) );
+    }
+    cout << "stalls after normal frames: " << watchdog.GetStallCount() << " (expected 0)" << endl;
+
+    // a stalled frame inside nested zones
+    watchdog.Heartbeat();
+    {
+        PROFILE_SCOPE( "Frame" );
+        PROFILE_SCOPE( "Update" );
+        loadMesh();
+    }
+    watchdog.Heartbeat();
+    Sleep( millisec( 60 ) );  // let the watchdog close the report
+
+    StallReport reports[4];
+    size_t n = watchdog.GetReports( reports, 4 );
+    cout << "stalls: " << n << " (expected 1), handler calls: " << handled << endl;
+    if (n)
+    {
+        const StallReport& r = reports[0];
+        cout << "length: " << r.Length.asMilliSec() << " ms (expected ~300), ongoing: " << r.Ongoing
+            << ", same thread: " << (r.Thread == this_thread::get_id()) << endl;
+        cout << "zones:";
+        for (uint32_t i = 0; i < r.Depth && i < PROFILE_STACK_DEPTH; i++)
+            cout << " " << r.Zones[i];
+        cout << " (expected Frame Update LoadMesh)" << endl;
+    }
+
+    // disarmed pause is not reported
+    watchdog.Disarm();
+    Sleep( millisec( 250 ) );
+    watchdog.Heartbeat();
+    Sleep( millisec( 30 ) );
+    cout << "stalls after disarmed pause: " << watchdog.GetStallCount() << " (expected 1)" << endl;
+
+    // stop during a stall keeps it ongoing
+    Sleep( millisec( 200 ) );
+    watchdog.Stop();
+    n = watchdog.GetReports( reports, 4 );
+    cout << "stalls after stop: " << n << " (expected 2), last ongoing: " << reports[n - 1].Ongoing << endl;
+
+    ostringstream out;
+    cout << "report lines: " << watchdog.WriteReports( out ) << endl << out.str();
+    return 0;
+}
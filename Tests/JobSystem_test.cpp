@@ -0,0 +1,128 @@
+/*
+ * Simple test for JobSystem.hpp - parallel_for, children, continuations,
+ * reused handles, jobs from a foreign thread, parked workers and the speedup
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <ctime>
+using namespace std;
+
+#include "JobSystem.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+int main()
+{
+    JobSystem jobs( max( 4u, thread::hardware_concurrency() ) );  // several workers even on a single core
+    cout << "workers: " << jobs.GetWorkerCount() << endl;
+
+    // parallel_for covers every index exactly once
+    {
+        vector<int> hits( 1000003, 0 );
+        jobs.ParallelFor( hits.size(), 0, [&]( size_t b, size_t e ) { for (size_t i = b; i < e; i++) hits[i]++; } );
+        size_t bad = 0;
+        for (int h : hits)
+            bad += h != 1;
+        cout << "parallel_for wrong hits: " << bad << " (expected 0)" << endl;
+    }
+
+    // far more chunks than job slots of a thread: full rings run the rest inline
+    {
+        vector<int> hits( JOBS_PER_THREAD * 25, 0 );
+        jobs.ParallelFor( hits.size(), 1, [&]( size_t b, size_t e ) { for (size_t i = b; i < e; i++) hits[i]++; } );
+        size_t bad = 0;
+        for (int h : hits)
+            bad += h != 1;
+        cout << "parallel_for of " << hits.size() << " single chunks, wrong hits: " << bad << " (expected 0)" << endl;
+
+        atomic<int> children{ 0 };
+        JobSystem::JobHandle parent = jobs.Spawn( [&]
+        {
+            for (size_t i = 0; i < JOBS_PER_THREAD * 3; i++)
+                jobs.Spawn( [&] { children++; }, JobSystem::CurrentJob() );
+        } );
+        jobs.Wait( parent );
+        cout << "children over ring size: " << children << " (expected " << JOBS_PER_THREAD * 3 << ")" << endl;
+    }
+
+    // children keep the parent unfinished, continuations run after
+    {
+        atomic<int> children{ 0 };
+        atomic<int> seenByContinuation{ -1 };
+        JobSystem::JobHandle parent = jobs.Create( [&]
+        {
+            for (int i = 0; i < 100; i++)
+                jobs.Spawn( [&] { Sleep( microsec( 100 ) ); children++; }, JobSystem::CurrentJob() );
+        } );
+        JobSystem::JobHandle after = jobs.CreateContinuation( parent, [&] { seenByContinuation = children.load(); } );
+        jobs.Run( parent );
+        jobs.Wait( parent );
+        cout << "children done with parent: " << children << " (expected 100)" << endl;
+        jobs.Wait( after );
+        cout << "continuation saw: " << seenByContinuation << " (expected 100)" << endl;
+    }
+
+    // a handle of a finished job stays done after its slot is reused
+    {
+        JobSystem::JobHandle old = jobs.Spawn( [] {} );
+        jobs.Wait( old );
+        vector<JobSystem::JobHandle> newer;
+        bool reused = false;
+        while (!reused && newer.size() < JOBS_PER_THREAD)  // not run yet: unfinished
+        {
+            newer.push_back( jobs.Create( [] {} ) );
+            reused = newer.back().Slot == old.Slot;
+        }
+        cout << "slot reused: " << reused << ", old job done: " << JobSystem::IsDone( old ) << ", newer job done: " << JobSystem::IsDone( newer.back() ) << " (expected 1 1 0)" << endl;
+        for (JobSystem::JobHandle& h : newer)
+            jobs.Run( h );
+        jobs.Wait( old );
+        for (JobSystem::JobHandle& h : newer)
+            jobs.Wait( h );
+    }
+
+    // a foreign thread runs and waits for jobs
+    {
+        atomic<long> sum{ 0 };
+        thread foreign( [&]
+        {
+            JobSystem::JobHandle root = jobs.CreateParallelFor( 10000, 100, [&]( size_t b, size_t e ) { for (size_t i = b; i < e; i++) sum += long( i ); } );
+            jobs.Run( root );
+            jobs.Wait( root );
+        } );
+        foreign.join();
+        cout << "sum from foreign thread: " << sum << " (expected 49995000)" << endl;
+    }
+
+    // idle workers park instead of spinning
+    {
+        clock_t cpu = clock();
+        Sleep( millisec( 300 ) );
+        double used = double( clock() - cpu ) / CLOCKS_PER_SEC;
+        cout << "CPU while idle: " << used * 1000 << " ms for 300 ms (expected ~0)" << endl;
+    }
+
+    // speedup on a per-element workload, many frames
+    {
+        vector<float> data( 1 << 20 );
+        auto body = [&]( size_t b, size_t e ) { for (size_t i = b; i < e; i++) data[i] = sqrtf( float( i ) ) * sinf( float( i ) ); };
+        Duration start = ProgramTime();
+        for (int frame = 0; frame < 20; frame++)
+            body( 0, data.size() );
+        Duration serial = ProgramTime() - start;
+        start = ProgramTime();
+        for (int frame = 0; frame < 20; frame++)
+            jobs.ParallelFor( data.size(), 4096, body );
+        Duration parallel = ProgramTime() - start;
+        cout << "serial " << serial.asMilliSec() / 20 << " ms, parallel " << parallel.asMilliSec() / 20 << " ms per frame, speedup " << serial.asSec() / parallel.asSec() << endl;
+
+        start = ProgramTime();
+        for (int i = 0; i < 100000; i++)
+            jobs.Wait( jobs.Spawn( [] {} ) );
+        cout << "spawn + wait: " << (ProgramTime() - start).asMicroSec() * 1000 / 100000 << " ns" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Simple test for the policy-based timers of Timer.hpp - pause and resume
+ * accumulation, Restart/Reset/Stop results and the scale factor of
+ * StopwatchTimer, PausableTimer and ScaledTimer on given moments, and the
+ * Timer adapter against the former Timer implementation
+ */
+
+#include <iostream>
+using namespace std;
+
+#include "Timer.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+static Duration ms( long v ) { return millisec( v ); }
+
+// the former Timer (four moments and a scratch member), reading given moments
+struct OldTimer
+{
+    const Duration PrestartT = Duration( -1 );
+    Duration StartT, StopT, CountedT, LastT;
+
+    explicit OldTimer( const Duration& Now ) { StartT = StopT = LastT = Now; }
+
+    void Start( const Duration& Now, const Duration& dt = ZERO_Duration )
+    {
+        StartT = LastT = Now;
+        StopT = PrestartT;
+        CountedT += dt;
+    }
+    Duration Stop( const Duration& Now )
+    {
+        if (StopT < StartT)
+        {
+            CountedT += Now - LastT;
+            LastT = Now;
+        }
+        StopT = Now;
+        return CountedT;
+    }
+    Duration Reset( const Duration& Now, const Duration& dt = ZERO_Duration )
+    {
+        if (StopT < StartT)
+            CountedT += Now - LastT;
+        StopT = StartT = LastT = Now;
+        Duration Prev = CountedT;
+        CountedT = dt;
+        return Prev;
+    }
+    Duration Restart( const Duration& Now, const Duration& dt = ZERO_Duration )
+    {
+        if (StopT < StartT)
+            CountedT += Now - LastT;
+        StartT = LastT = Now;
+        StopT = PrestartT;
+        Duration Prev = CountedT;
+        CountedT = dt;
+        return Prev;
+    }
+    Duration Update( const Duration& Now )
+    {
+        if (StopT < StartT)
+        {
+            CountedT += Now - LastT;
+            LastT = Now;
+        }
+        return CountedT;
+    }
+};
+
+// the adapter with its moment-taking implementations opened
+struct AdapterTimer : Timer
+{
+    AdapterTimer() : Timer( ZERO_Duration ) {}
+    using Timer::StartAt;
+    using Timer::StopAt;
+    using Timer::ResetAt;
+    using Timer::RestartAt;
+    using Timer::UpdateAt;
+};
+
+int main()
+{
+    // StopwatchTimer: pauses keep the counted time, Restart returns it
+    {
+        StopwatchTimer<> t;
+        cout << "stopwatch idle: on " << t.IsOn() << ", " << t.GetTime().asMilliSec() << " ms (expected 0 0)" << endl;
+        t.StartAt( ms( 10 ) );
+        cout << "stopwatch run 20 ms: " << t.StopAt( ms( 30 ) ).asMilliSec() << " (expected 20)" << endl;
+        cout << "paused 20 ms: " << t.UpdateAt( ms( 50 ) ).asMilliSec() << " (expected 20)" << endl;
+        t.StartAt( ms( 60 ), ms( 5 ) );  // resume with a bonus
+        cout << "resumed 10 ms with 5 ms added: " << t.UpdateAt( ms( 70 ) ).asMilliSec() << " (expected 35)" << endl;
+        t.StartAt( ms( 75 ) );  // Start on a running timer keeps counting
+        cout << "started again while on: " << t.UpdateAt( ms( 80 ) ).asMilliSec() << " (expected 45)" << endl;
+        cout << "restart returns: " << t.RestartAt( ms( 90 ), ms( 1 ) ).asMilliSec() << " (expected 55)";
+        cout << ", then counts from 1 ms: " << t.UpdateAt( ms( 100 ) ).asMilliSec() << " (expected 11)" << endl;
+        cout << "reset returns: " << t.ResetAt( ms( 110 ) ).asMilliSec() << " (expected 21), on " << t.IsOn() << ", "
+            << t.UpdateAt( ms( 200 ) ).asMilliSec() << " ms (expected 0 0)" << endl;
+    }
+
+    // PausableTimer: the same counting, plus the moment of the last event
+    {
+        PausableTimer<> t( ms( 0 ) );
+        t.StartAt( ms( 10 ) );
+        t.UpdateAt( ms( 25 ) );
+        cout << "pausable last update: " << t.GetLast().asMilliSec() << " (expected 25)";
+        t.StopAt( ms( 40 ) );
+        cout << ", stop moment: " << t.GetLast().asMilliSec() << " (expected 40), counted " << t.GetTime().asMilliSec() << " (expected 30)" << endl;
+        t.StartAt( ms( 100 ) );
+        cout << "pausable after a 60 ms pause and 10 ms run: " << t.StopAt( ms( 110 ) ).asMilliSec() << " (expected 40)" << endl;
+    }
+
+    // ScaledTimer: counted time follows the scale, zero scale pauses
+    {
+        ScaledTimer<> t( 0.5 );
+        t.StartAt( ms( 0 ) );
+        cout << "scaled 100 ms at 0.5: " << t.UpdateAt( ms( 100 ) ).asMilliSec() << " (expected 50)" << endl;
+        t.SetScaleAt( ms( 100 ), 2. );
+        cout << "then 10 ms at 2: " << t.UpdateAt( ms( 110 ) ).asMilliSec() << " (expected 70)" << endl;
+        t.SetScaleAt( ms( 110 ), 0. );
+        cout << "then 90 ms at 0: " << t.UpdateAt( ms( 200 ) ).asMilliSec() << " (expected 70)" << endl;
+        t.SetScaleAt( ms( 200 ), 1. );
+        cout << "stop after 30 ms at 1: " << t.StopAt( ms( 230 ) ).asMilliSec() << " (expected 100)";
+        t.SetScale( 3. );  // while stopped: nothing to count
+        t.StartAt( ms( 300 ) );
+        cout << ", 10 ms at 3 after the pause: " << t.StopAt( ms( 310 ) ).asMilliSec() << " (expected 130), scale " << t.GetScale() << " (expected 3)" << endl;
+        cout << "restart returns: " << t.RestartAt( ms( 400 ) ).asMilliSec() << " (expected 130), then " << t.UpdateAt( ms( 410 ) ).asMilliSec() << " (expected 30)" << endl;
+    }
+
+    // clock-reading forms on the real clock
+    {
+        PausableTimer<> t;
+        t.Start();
+        Sleep( ms( 20 ) );
+        t.Stop();
+        Sleep( ms( 20 ) );
+        t.Start();
+        Sleep( ms( 20 ) );
+        cout << "real clock, 20 ms on, 20 off, 20 on: " << t.Stop().asMilliSec() << " ms (expected ~40)" << endl;
+    }
+
+    // Timer adapter gives the former results and moments on the same script.
+    // Start on a running timer is left out: it dropped the time since the
+    // last Update before and counts it now
+    {
+        OldTimer old( ZERO_Duration );
+        AdapterTimer adapter;
+        int mismatches = 0, steps = 0;
+        auto check = [&]( const Duration& a, const Duration& b )
+        {
+            mismatches += a != b || old.CountedT != adapter.GetTime() || old.StartT != adapter.GetStart()
+                || old.StopT != adapter.GetStop() || old.LastT != adapter.GetLast() || (old.StopT < old.StartT) != adapter.IsOn();
+            steps++;
+        };
+        old.Start( ms( 10 ) ); adapter.StartAt( ms( 10 ), ZERO_Duration ); check( ZERO_Duration, ZERO_Duration );
+        check( old.Update( ms( 15 ) ), adapter.UpdateAt( ms( 15 ) ) );
+        check( old.Stop( ms( 20 ) ), adapter.StopAt( ms( 20 ) ) );
+        check( old.Update( ms( 30 ) ), adapter.UpdateAt( ms( 30 ) ) );
+        old.Start( ms( 40 ), ms( 3 ) ); adapter.StartAt( ms( 40 ), ms( 3 ) ); check( ZERO_Duration, ZERO_Duration );
+        check( old.Update( ms( 45 ) ), adapter.UpdateAt( ms( 45 ) ) );
+        check( old.Restart( ms( 50 ), ms( 2 ) ), adapter.RestartAt( ms( 50 ), ms( 2 ) ) );
+        check( old.Update( ms( 60 ) ), adapter.UpdateAt( ms( 60 ) ) );
+        check( old.Reset( ms( 70 ), ms( 1 ) ), adapter.ResetAt( ms( 70 ), ms( 1 ) ) );
+        check( old.Update( ms( 80 ) ), adapter.UpdateAt( ms( 80 ) ) );
+        check( old.Restart( ms( 90 ) ), adapter.RestartAt( ms( 90 ), ZERO_Duration ) );
+        check( old.Stop( ms( 95 ) ), adapter.StopAt( ms( 95 ) ) );
+        check( old.Reset( ms( 100 ) ), adapter.ResetAt( ms( 100 ), ZERO_Duration ) );
+        old.Start( ms( 110 ) ); adapter.StartAt( ms( 110 ), ZERO_Duration ); check( ZERO_Duration, ZERO_Duration );
+        check( old.Stop( ms( 130 ) ), adapter.StopAt( ms( 130 ) ) );
+        cout << "adapter vs former Timer: " << mismatches << " mismatches in " << steps << " steps (expected 0), counted "
+            << adapter.GetTime().asMilliSec() << " ms (expected 20)" << endl;
+
+        Timer real;  // public interface on the real clock
+        real.Start();
+        Sleep( ms( 20 ) );
+        Duration stopped = real.Stop();
+        cout << "Timer on real clock: " << stopped.asMilliSec() << " ms (expected ~20), stop moment " << (real.GetStop() == real.GetLast())
+            << ", on " << real.IsOn() << " (expected 1 0)" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Simple test for Profiler.hpp - nested zones in two threads, ring buffer
+ * wrap-around and Chrome trace output
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+#include "Profiler.hpp"
+using namespace Perspective;
+
+volatile int sink;
+
+void work( int n )
+{
+    PROFILE_SCOPE( "work" );
+    for (int i = 0; i < n; i++)
+    {
+        PROFILE_SCOPE( "inner" );
+        sink = sink + i;
+    }
+}
+
+size_t count( const string& s, const string& what )
+{
+    size_t n = 0;
+    for (size_t p = s.find( what ); p != string::npos; p = s.find( what, p + 1 ))
+        n++;
+    return n;
+}
+
+int main()
+{
+    ProfileThreadInit( "Main" );
+    thread worker( [] { ProfileThreadInit( "Worker" ); work( 10 ); } );
+    worker.join();
+    work( 5 );
+
+    ostringstream trace;
+    size_t events = WriteChromeTrace( trace );
+    cout << "events: " << events << " (expected 17)" << endl;
+    cout << "inner zones: " << count( trace.str(), "\"inner\"" ) << " (expected 15)" << endl;
+    cout << "thread names: " << count( trace.str(), "thread_name" ) << " (expected 2)" << endl;
+
+    // overhead and wrap-around: only the last PROFILE_EVENTS_PER_THREAD are kept
+    const int N = 1000000;
+    Duration start = ProgramTime();
+    for (int i = 0; i < N; i++)
+    {
+        PROFILE_SCOPE( "bench" );
+    }
+    cout << "zone: " << (ProgramTime() - start).asMicroSec() * 1000 / N << " ns" << endl;
+
+    SetProfilerEnabled( false );
+    start = ProgramTime();
+    for (int i = 0; i < N; i++)
+    {
+        PROFILE_SCOPE( "bench" );
+    }
+    cout << "disabled zone: " << (ProgramTime() - start).asMicroSec() * 1000 / N << " ns" << endl;
+    SetProfilerEnabled( true );
+
+    ostringstream full;
+    cout << "events after wrap: " << WriteChromeTrace( full ) << " (expected " << PROFILE_EVENTS_PER_THREAD - 1 << ": the oldest slot may be in rewrite, finished worker already dumped)" << endl;
+
+    // thread churn: buffers of finished and dumped threads are reused
+    uint32_t maxId = 0;
+    for (int i = 0; i < 50; i++)
+    {
+        thread t( [&] { work( 2 ); maxId = max( maxId, ProfileThreadId() ); } );
+        t.join();
+        ostringstream dump;
+        WriteChromeTrace( dump );
+    }
+    cout << "largest thread id of 50 short threads: " << maxId << " (expected 2)" << endl;
+
+    ClearProfile();
+    ostringstream empty;
+    cout << "events after clear: " << WriteChromeTrace( empty ) << " (expected 0)" << endl;
+
+    cout << (WriteChromeTrace( "profile_test.json" ) ? "written profile_test.json" : "can't write profile_test.json") << endl;
+    return 0;
+}
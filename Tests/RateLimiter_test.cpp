@@ -0,0 +1,99 @@
+/*
+ * Simple test for TimeUtils.hpp::RateLimiter - bursts and refill on a
+ * ManualClock, exact accounting under contention, waiting acquire
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cmath>
+using namespace std;
+
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+int main()
+{
+    // 100 units per second, bursts of 10, on a stopped clock
+    {
+        ManualClock clock;
+        ScopedTimeSource scope( clock );
+        RateLimiter limiter( 100, 10 );
+        int got = 0;
+        while (limiter.TryAcquire())
+            got++;
+        cout << "burst: " << got << " (expected 10)" << endl;
+        clock.Advance( millisec( 50 ) );
+        got = 0;
+        while (limiter.TryAcquire())
+            got++;
+        cout << "after 50 ms: " << got << " (expected 5)\twait for 3: " << limiter.WaitTime( 3 ).asMilliSec() << " ms (expected 30)" << endl;
+        clock.Advance( seconds( 10 ) );
+        cout << "after idle: " << limiter.Available() << " (expected 10, no overfill)\t20 at once: " << limiter.TryAcquire( 20 ) << " (expected 0)" << endl;
+
+        // contention: exactly the burst is granted while the clock stands
+        std::atomic<int> granted{ 0 };
+        vector<thread> threads;
+        for (int t = 0; t < 8; t++)
+            threads.emplace_back( [&] { for (int i = 0; i < 100000; i++) if (limiter.TryAcquire()) granted++; } );
+        for (thread& t : threads)
+            t.join();
+        cout << "granted under contention: " << granted << " (expected 10)" << endl;
+    }
+
+    // bandwidth: 1 MB/s in 64 KB bursts on a VirtualClock, waiting acquires
+    {
+        VirtualClock clock;
+        ScopedTimeSource scope( clock );
+        RateLimiter bandwidth( 1000000, 65536 );
+        Duration start = ProgramTime();
+        size_t sent = 0;
+        while (sent < 10000000)
+        {
+            bandwidth.AcquireUntil( 4096, MAX_Duration );
+            sent += 4096;
+        }
+        cout << "10 MB sent in " << (ProgramTime() - start).asSec() << " s of virtual time (expected ~9.93)" << endl;
+        cout << "deadline too close: " << bandwidth.AcquireFor( 65536, millisec( 1 ) ) << " (expected 0)" << endl;
+    }
+
+    // rates <= 0 and non-finite are rejected, a limiter built with one
+    // grants its burst and never refills
+    {
+        RateLimiter limiter( 100, 10 );
+        cout << "rate 0, -1, NaN, inf accepted: " << limiter.SetRate( 0, 10 ) << limiter.SetRate( -1, 10 )
+            << limiter.SetRate( NAN, 10 ) << limiter.SetRate( INFINITY, 10 ) << " (expected 0000)" << endl;
+        RateLimiter never( 0, 3 );
+        Duration now = ProgramTime();
+        int got = 0;
+        for (int i = 0; i < 10; i++)
+            got += never.TryAcquireAt( now + seconds( 1000. * i ) );
+        cout << "rate 0 grants over 9000 s: " << got << " (expected 3)" << endl;
+        RateLimiter slow( 1e-300, 2 );  // clamped, no overflow
+        cout << "rate 1e-300 grants: " << slow.TryAcquireAt( now, 2 ) << slow.TryAcquireAt( now + seconds( 1000. ) ) << " (expected 10)" << endl;
+    }
+
+    // waiting on the coarse clock, which often doesn't move during a short
+    // sleep, and requests beyond the burst at a slow rate
+    {
+        RateLimiter limiter( 2000, 1 );
+        limiter.TryAcquire();
+        int got = 0;
+        for (int i = 0; i < 50; i++)
+            got += limiter.AcquireFor( 1, millisec( 100 ) );
+        cout << "coarse clock waits: " << got << " of 50 (expected 50)" << endl;
+        RateLimiter slow( 1e-300, 4 );
+        cout << "4000 of burst 4: " << slow.TryAcquire( 4000 ) << "\twait: " << (slow.WaitTime( 4000 ) == MAX_Duration) << " (expected 0 1)" << endl;
+    }
+
+    // real time cost
+    {
+        PreciseRateLimiter limiter( 1e12, 1000000 );
+        Duration start = ProgramTime();
+        int granted = 0;
+        for (int i = 0; i < 10000000; i++)
+            granted += limiter.TryAcquireAt( start );
+        cout << "TryAcquireAt: " << (ProgramTime() - start).asMicroSec() * 1000 / 10000000 << " ns (" << granted << " granted)" << endl;
+    }
+    return 0;
+}
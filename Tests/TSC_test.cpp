@@ -0,0 +1,88 @@
+/*
+ * Simple test for the TSC backend of Timer.hpp - piecewise slew mapping,
+ * agreement with steady_clock and monotonic readings while calibrations are
+ * republished by another thread.
+ * Build with the backend: g++ -std=c++17 -DPER_TIME_TSC -I../Core TSC_test.cpp ../Core/Timer.cpp -pthread
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+#include "Timer.hpp"
+
+#if defined(PER_TIME_TSC)
+using namespace Perspective;
+
+int main()
+{
+    // slew window at double rate, true rate afterwards
+    _TSC_calibration c{ 1000, 5000, int64_t( 1 ) << _TSC_SHIFT, 100, 200, int64_t( 2 ) << _TSC_SHIFT };
+    cout << "inside slew window: " << _TSC_convert( c, 1050 ) << " (expected 5100)" << endl;
+    cout << "after slew window: " << _TSC_convert( c, 1300 ) << " (expected 5400)" << endl;
+    cout << "window end is continuous: " << _TSC_convert( c, 1099 ) + 2 << " ~ " << _TSC_convert( c, 1100 ) << endl;
+
+    // calibrated lazily: nothing at startup, the rate over the first 2 ms of readings
+    cout << "TSC active before readings: " << IsTSCActive() << " (expected 0)" << endl;
+    Duration first = ProgramTime();
+    while (ProgramTime() - first < millisec( 3 ))
+        ;
+    cout << "TSC active: " << IsTSCActive() << " (0 - steady_clock fallback, no invariant TSC)" << endl;
+    CheckTSCCalibration();
+    time_tick_t steady = chrono::steady_clock::now().time_since_epoch().count();
+    time_tick_t tsc = SystemTime().getTicks();
+    cout << "difference with steady_clock: " << Duration( tsc - steady ).asMicroSec() << " us (expected ~0)" << endl;
+
+    // readers check monotonicity and jumps while calibrations are republished
+    // with zero tolerance, i.e. on every check
+    atomic<bool> stop{ false };
+    atomic<int> backwards{ 0 }, jumps{ 0 };
+    atomic<long> republished{ 0 };
+    vector<thread> readers;
+    for (int r = 0; r < 3; r++)
+        readers.emplace_back( [&]
+        {
+            Duration last = ProgramTime();
+            while (!stop)
+            {
+                Duration now = ProgramTime();
+                backwards += now < last;
+                jumps += now - last > millisec( 50 );  // a torn calibration lands far away
+                last = now;
+            }
+        } );
+    thread checker( [&]
+    {
+        for (int i = 0; i < 20000; i++)
+            republished += !CheckTSCCalibration( ZERO_Duration );
+        stop = true;
+    } );
+    checker.join();
+    for (thread& t : readers)
+        t.join();
+    cout << "republished: " << republished << ", backwards: " << backwards << " (expected 0), jumps: " << jumps << " (expected 0)" << endl;
+
+    // after the slew window the refined rate matches steady_clock
+    this_thread::sleep_for( chrono::milliseconds( 1100 ) );
+    Duration t0 = ProgramTime();
+    auto s0 = chrono::steady_clock::now();
+    this_thread::sleep_for( chrono::milliseconds( 300 ) );
+    Duration t1 = ProgramTime();
+    auto s1 = chrono::steady_clock::now();
+    double steadyUs = chrono::duration<double, micro>( s1 - s0 ).count();
+    cout << "rate after slew: " << (t1 - t0).asMicroSec() / steadyUs << " (expected ~1)" << endl;
+    return 0;
+}
+
+#else
+
+int main()
+{
+    cout << "TSC backend is not compiled in: build with -DPER_TIME_TSC" << endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Simple test for TimeBulk.hpp - bulk conversions against Duration::as*()
+ * including extreme values, summary against a plain loop, speed
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+using namespace std;
+
+#include "TimeBulk.hpp"
+using namespace Perspective;
+
+// relative difference, tolerates last-bit differences of reciprocal scaling
+bool close( double a, double b ) { return a == b || fabs( a - b ) <= 4e-16 * max( fabs( a ), fabs( b ) ); }
+
+int main()
+{
+    cout << "kernel: " << GetBulkKernel() << endl;
+
+    const size_t N = 1000003;  // odd: tails of vector loops are used too
+    mt19937_64 rnd( 42 );
+    vector<Duration> d( N );
+    for (size_t i = 0; i < N; i++)
+        d[i] = Duration( time_tick_t( rnd() ) >> (rnd() % 64) );
+    d[0] = MAX_Duration;
+    d[1] = MIN_Duration;
+    d[2] = ZERO_Duration;
+    d[3] = Duration( -1 );
+
+    vector<double> ms( N ), us( N ), s( N );
+    vector<float> msf( N );
+    ConvertToMilliSec( d.data(), N, ms.data() );
+    ConvertToMicroSec( d.data(), N, us.data() );
+    ConvertToSec( d.data(), N, s.data() );
+    ConvertToMilliSec( d.data(), N, msf.data() );
+    long long errors = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        errors += !close( ms[i], d[i].asMilliSec() );
+        errors += !close( us[i], d[i].asMicroSec() );
+        errors += !close( s[i], d[i].asSec() );
+        errors += !close( msf[i], float( d[i].asMilliSec() ) ) && fabs( msf[i] - float( d[i].asMilliSec() ) ) > 1e-7 * fabs( msf[i] );
+    }
+    cout << "conversion errors: " << errors << " (expected 0)" << endl;
+
+    // frame times: realistic summary
+    vector<Duration> frames( N );
+    for (size_t i = 0; i < N; i++)
+        frames[i] = millisec( 16 ) + Duration( time_tick_t( rnd() % 2000000 ) - 1000000 );
+    time_tick_t sum = 0, lo = MAX_TICK, hi = MIN_TICK;
+    for (const Duration& f : frames)
+    {
+        sum += f.getTicks();
+        lo = min( lo, f.getTicks() );
+        hi = max( hi, f.getTicks() );
+    }
+    DurationSummary S = SummarizeDurations( frames.data(), N );
+    cout << "summary errors: " << (S.Count != N) + (S.Sum.getTicks() != sum) + (S.Min.getTicks() != lo) + (S.Max.getTicks() != hi)
+        + (S.Mean.getTicks() != sum / time_tick_t( N )) << " (expected 0)" << endl;
+    DurationSummary E = SummarizeDurations( frames.data(), 0 );
+    cout << "empty: " << E.Count << " " << (E.Mean == ZERO_Duration) << " (expected 0 1)" << endl;
+
+    // speed against per-element asMilliSec()
+    Duration start = ProgramTime();
+    for (int r = 0; r < 10; r++)
+        ConvertToMilliSec( frames.data(), N, ms.data() );
+    Duration bulk = ProgramTime() - start;
+    start = ProgramTime();
+    for (int r = 0; r < 10; r++)
+        for (size_t i = 0; i < N; i++)
+            ms[i] = frames[i].asMilliSec();
+    Duration plain = ProgramTime() - start;
+    start = ProgramTime();
+    for (int r = 0; r < 10; r++)
+        S = SummarizeDurations( frames.data(), N );
+    Duration summary = ProgramTime() - start;
+    cout << "bulk: " << bulk.asMicroSec() * 100 / N << " ns/value\tasMilliSec(): " << plain.asMicroSec() * 100 / N
+        << " ns/value\tsummary: " << summary.asMicroSec() * 100 / N << " ns/value" << endl;
+    return 0;
+}
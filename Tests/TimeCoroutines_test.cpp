@@ -0,0 +1,148 @@
+/*
+ * Simple test for TimeCoroutines.hpp - script-like coroutines on real time,
+ * ten thousand sleepers on a VirtualClock, NextTick per frame.
+ * Requires C++20: g++ -std=c++20 -I../Core TimeCoroutines_test.cpp ../Core/TimeCoroutines.cpp ../Core/TimeUtils.cpp ../Core/Timer.cpp -pthread
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <stdexcept>
+using namespace std;
+
+#include "TimeCoroutines.hpp"
+
+#if defined(__cpp_impl_coroutine)
+using namespace Perspective;
+
+Duration worstLate = ZERO_Duration;
+
+// patrols: sleeps Period Steps times, tracks lateness
+Async::Task patrol( Duration period, int steps, int* done )
+{
+    for (int i = 0; i < steps; i++)
+    {
+        Duration expected = ProgramTime() + period;
+        co_await Async::SleepFor( period );
+        worstLate = max( worstLate, ProgramTime() - expected );
+    }
+    ++*done;
+}
+
+// sleeps until a moment, checks it is never resumed early
+Async::Task alarm( Duration moment, long long* early, vector<Duration>* order )
+{
+    co_await Async::SleepUntil( moment );
+    if (ProgramTime() < moment)
+        ++*early;
+    order->push_back( moment );
+}
+
+// counts frames with NextTick
+Async::Task frameCounter( int frames, int* counted )
+{
+    for (int i = 0; i < frames; i++)
+    {
+        co_await Async::NextTick();
+        ++*counted;
+    }
+}
+
+// yields with zero sleeps, records the order of turns
+Async::Task yielder( char name, int turns, string* trace )
+{
+    for (int i = 0; i < turns; i++)
+    {
+        *trace += name;
+        co_await Async::SleepFor( ZERO_Duration );
+    }
+}
+
+// throws after a sleep
+Async::Task failing()
+{
+    co_await Async::SleepFor( millisec( 1 ) );
+    throw runtime_error( "script error" );
+}
+
+int main()
+{
+    // real time: a few script-like coroutines driven by Run
+    {
+        Async::Executor exec;
+        int done = 0;
+        exec.Spawn( patrol( millisec( 5 ), 20, &done ) );
+        exec.Spawn( patrol( millisec( 7 ), 15, &done ) );
+        exec.Spawn( patrol( millisec( 11 ), 10, &done ) );
+        Duration start = ProgramTime();
+        exec.Run();
+        cout << "patrols done: " << done << " (expected 3) in " << (ProgramTime() - start).asMilliSec()
+            << " ms (expected ~110)\tworst lateness: " << worstLate.asMicroSec() << " us" << endl;
+    }
+
+    // virtual time: ten thousand sleepers over an hour, resumed in deadline order
+    {
+        VirtualClock clock;
+        ScopedTimeSource scope( clock );
+        Async::Executor exec;
+        mt19937_64 rnd( 42 );
+        long long early = 0;
+        vector<Duration> order;
+        for (int i = 0; i < 10000; i++)
+            exec.Spawn( alarm( ProgramTime() + Duration( time_tick_t( rnd() % (3600 * TICKS_PER_SEC) ) ), &early, &order ) );
+        Duration start = SystemTime() - Time();
+        exec.Run();
+        bool sorted = true;
+        for (size_t i = 1; i < order.size(); i++)
+            sorted = sorted && order[i - 1] <= order[i];
+        cout << "alarms: " << order.size() << " (expected 10000)\tearly: " << early << " (expected 0)\tin order: " << sorted
+            << "\tvirtual time: " << (ProgramTime() - start).asSec() << " s" << endl;
+    }
+
+    // frame loop: NextTick resumes once per Poll
+    {
+        Async::Executor exec;
+        int counted = 0;
+        exec.Spawn( frameCounter( 100, &counted ) );
+        int frames = 0;
+        while (exec.Size())
+        {
+            exec.Poll();
+            frames++;
+        }
+        cout << "ticks: " << counted << " in " << frames << " polls (expected 100 in 101)" << endl;
+
+        // zero sleeps yield to other tasks
+        string trace;
+        exec.Spawn( yielder( 'a', 3, &trace ) );
+        exec.Spawn( yielder( 'b', 3, &trace ) );
+        exec.Run();
+        cout << "zero sleep turns: " << trace << " (expected ababab)" << endl;
+
+        // an exception finishes its task and passes through Run
+        exec.Spawn( failing() );
+        exec.Spawn( frameCounter( 100000, &counted ) );  // outlives the failing task
+        string caught;
+        try { exec.Run(); }
+        catch (const runtime_error& e) { caught = e.what(); }
+        cout << "caught: " << caught << " (expected script error), tasks left: " << exec.Size() << " (expected 1)" << endl;
+        exec.Run();
+        cout << "tasks after the next Run: " << exec.Size() << " (expected 0)" << endl;
+
+        // unfinished tasks are destroyed with the executor
+        exec.Spawn( frameCounter( 1000, &counted ) );
+        exec.Poll();
+    }
+    return 0;
+}
+
+#else
+
+int main()
+{
+    cout << "coroutines are not supported by this compiler mode, build with -std=c++20" << endl;
+    return 0;
+}
+
+#endif
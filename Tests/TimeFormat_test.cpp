@@ -0,0 +1,61 @@
+/*
+ * Simple test for TimeFormat.hpp::FormatISO8601()
+ */
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include "TimeFormat.hpp"
+using namespace Perspective;
+
+void stamp( int id )
+{
+    char buf[ISO8601_BUFFER_SIZE];
+    for (int i = 0; i < 3; i++)
+    {
+        FormatISO8601( GlobalTime(), buf, sizeof( buf ), 6 );
+        cout << id << "\t" << buf << endl;
+    }
+}
+
+int main()
+{
+    char buf[ISO8601_BUFFER_SIZE];
+
+    FormatISO8601( GlobalTime(), buf, sizeof( buf ), 9, true );
+    cout << "UTC now:   " << buf << endl;
+    FormatISO8601( GlobalTime(), buf, sizeof( buf ) );
+    cout << "Local now: " << buf << endl;
+    cout << "ctime:     " << GlobalTime().as_c_str() << endl;
+
+    cout << "Too small buffer returns: " << FormatISO8601( GlobalTime(), buf, 20 ) << endl;
+    // the extremes of the tick range format to a valid stamp or to nothing
+    FormatISO8601( Time( MAX_TICK ), buf, sizeof( buf ), 0, true );
+    cout << "Latest moment: " << buf << endl;
+    time_tick_t year10000 = 253402300800LL;  // seconds since epoch of 10000-01-01
+    if (year10000 <= MAX_TICK / TICKS_PER_SEC)  // reachable with coarse ticks only
+    {
+        cout << "Year 10000 returns: " << FormatISO8601( Time( year10000 * TICKS_PER_SEC ), buf, sizeof( buf ), 3, true ) << " (expected 0)" << endl;
+        FormatISO8601( Time( (year10000 - 1) * TICKS_PER_SEC ), buf, sizeof( buf ), 0, true );
+        cout << "Last second of year 9999: " << buf << " (expected 9999-12-31T23:59:59Z)" << endl;
+    }
+
+    // every thread has its own cache - no shared state
+    std::thread first( stamp, 1 );
+    std::thread second( stamp, 2 );
+    first.join();
+    second.join();
+
+    const int N = 10000000;
+    size_t total = 0;
+    Time base = GlobalTime();
+    Duration start = ProgramTime();
+    for (int i = 0; i < N; i++)
+        total += FormatISO8601( base + Duration( (time_tick_t)i * 1000 ), buf, sizeof( buf ), 6 );
+    Duration spent = ProgramTime() - start;
+
+    cout << "Formatted " << N << " stamps (" << total << " chars) in " << spent.asMilliSec() << " ms" << endl;
+    cout << "Per stamp: " << spent.asMicroSec() * 1000. / N << " ns" << endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Simple test for TimeHistogram.hpp - bucket layout, percentiles against
+ * sorted samples and concurrent recording from several threads
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+using namespace std;
+
+#include "TimeHistogram.hpp"
+using namespace Perspective;
+
+int main()
+{
+    // every interval lies within its bucket bounds, buckets are contiguous
+    long long errors = 0;
+    for (size_t b = 1; b < HISTOGRAM_BUCKETS; b++)
+        if (_histogram_lower( b ) != _histogram_upper( b - 1 ) + 1)
+            errors++;
+    mt19937_64 rnd( 42 );
+    for (int i = 0; i < 1000000; i++)
+    {
+        time_tick_t t = time_tick_t( rnd() >> (rnd() % 64) ) & ((time_tick_t( 1 ) << HISTOGRAM_MAX_BITS) - 1);
+        size_t b = _histogram_bucket( t );
+        if (t < _histogram_lower( b ) || t > _histogram_upper( b ))
+            errors++;
+    }
+    cout << "bucket errors: " << errors << " (expected 0)" << endl;
+
+    // percentiles within relative error of a single bucket
+    LatencyHistogram H( 4 );
+    vector<time_tick_t> samples;
+    lognormal_distribution<double> latency( 13, 1 );  // ~0.5 ms median in nanosecond ticks
+    for (int i = 0; i < 100000; i++)
+    {
+        samples.push_back( time_tick_t( latency( rnd ) ) );
+        H.Record( Duration( samples.back() ) );
+    }
+    sort( samples.begin(), samples.end() );
+    double worst = 0;
+    for (double p : { 50., 90., 99., 99.9, 100. })
+    {
+        time_tick_t exact = samples[size_t( p / 100 * samples.size() + 0.999999 ) - 1];
+        time_tick_t got = H.Percentile( p ).getTicks();
+        worst = max( worst, double( got - exact ) / exact );
+        cout << "p" << p << ": " << got << " exact " << exact << endl;
+    }
+    cout << "worst relative error: " << worst << " (expected < " << 1. / HISTOGRAM_SUB_BUCKETS << ")" << endl;
+    double mean = 0;
+    for (time_tick_t s : samples)
+        mean += s;
+    mean /= samples.size();
+    cout << "mean: " << H.Mean().getTicks() << " exact " << mean << endl;
+    cout << "min: " << H.Min().getTicks() << " exact " << samples.front()
+        << "\tmax: " << H.Max().getTicks() << " exact " << samples.back() << endl;
+
+    // concurrent records are all counted
+    LatencyHistogram C;
+    vector<thread> threads;
+    for (int t = 0; t < 8; t++)
+        threads.emplace_back( [&C, t] { for (int i = 0; i < 1000000; i++) C.Record( Duration( (i + t) % 5000 ) ); } );
+    for (thread& t : threads)
+        t.join();
+    cout << "shards: " << C.GetShards() << "\tcount: " << C.Count() << " (expected 8000000)" << endl;
+
+    Duration start = ProgramTime();
+    for (int i = 0; i < 10000000; i++)
+        C.Record( Duration( i ) );
+    cout << "record: " << (ProgramTime() - start).asMicroSec() * 1000 / 10000000 << " ns" << endl;
+    C.Reset();
+    cout << "after reset: " << C.Count() << " (expected 0)" << endl;
+    return 0;
+}
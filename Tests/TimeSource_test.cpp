@@ -0,0 +1,59 @@
+/*
+ * Simple test for TimeSource override - ManualClock stepped by a test,
+ * VirtualClock running an hour of FixedStepLoop simulation in a moment
+ */
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include "TimeUtils.hpp"
+#include "FixedStepLoop.hpp"
+using namespace Perspective;
+
+int main()
+{
+    // manual clock: timers follow it, sleepers wait for it
+    {
+        ManualClock clock( ZERO_Duration );
+        ScopedTimeSource scope( clock );
+        Timer timer;
+        timer.Start();
+        clock.Advance( seconds( 5 ) );
+        cout << "timer: " << timer.Update().asSec() << " s (expected 5)" << endl;
+
+        ElementaryTimer elementary;
+        FrameClock::Tick();
+        int frames = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            clock.Advance( millisec( 500 ) );
+            frames += FrameClock::Tick() == millisec( 500 ) ? 1 : 0;
+        }
+        cout << "exact frame deltas: " << frames << " (expected 10)\telementary: " << elementary.GetTime().asSec() << " s (expected 5)" << endl;
+
+        bool woke = false;
+        thread sleeper( [&] { SleepUntil( seconds( 65 ) ); woke = true; } );  // blocks until the clock is moved
+        clock.Advance( seconds( 61 ) );
+        sleeper.join();
+        cout << "sleeper woke: " << woke << " at " << ProgramTime().asSec() << " s (expected 1 at 71)" << endl;
+    }
+
+    // back on the OS clock
+    Duration real = ProgramTime();
+    Sleep( millisec( 1 ) );
+    cout << "real clock restored: " << ((ProgramTime() - real) >= millisec( 1 )) << " (expected 1)" << endl;
+
+    // virtual clock: an hour of 60 Hz simulation as fast as possible
+    {
+        VirtualClock clock;
+        ScopedTimeSource scope( clock );
+        FixedStepLoop loop( seconds( 1 ) / 60. );
+        Duration start = SystemTime() - Time();  // SystemTime() follows the virtual clock too
+        loop.RunHeadless( [&]( const Duration& ) { if (loop.GetSimTime() >= seconds( 3600 )) loop.Stop(); } );
+        cout << "simulated: " << loop.GetSimTime().asSec() << " s in " << loop.GetStepCount() << " steps (expected ~3600 s, 216000 steps)" << endl;
+        cout << "virtual time passed: " << (ProgramTime() - start).asSec() << " s" << endl;
+    }
+    cout << "real time spent: " << (ProgramTime() - real).asMilliSec() << " ms" << endl;
+    return 0;
+}
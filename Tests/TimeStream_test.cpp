@@ -0,0 +1,108 @@
+/*
+ * Simple test for TimeStream.hpp - round trip of frame-like and random
+ * stamps, compression ratio, random seeks and bulk decode speed
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+using namespace std;
+
+#include "TimeStream.hpp"
+using namespace Perspective;
+
+// encodes, decodes in bulk and by seeks, counts mismatches
+long long roundTrip( const char* name, const vector<time_tick_t>& values, bool dod )
+{
+    TimeStreamWriter writer( 256, dod );
+    writer.Append( values.data(), values.size() );
+    const vector<uint8_t>& bytes = writer.Finish();
+
+    TimeStreamReader reader;
+    if (!reader.Open( bytes ))
+    {
+        cout << name << ": can't open stream" << endl;
+        return 1;
+    }
+    long long errors = 0;
+    vector<time_tick_t> decoded( values.size() );
+    Duration start = ProgramTime();
+    size_t n = reader.Decode( 0, decoded.data(), decoded.size() );
+    Duration spent = ProgramTime() - start;
+    errors += n != values.size();
+    for (size_t i = 0; i < n; i++)
+        errors += decoded[i] != values[i];
+
+    mt19937_64 rnd( 7 );
+    for (int i = 0; i < 10000; i++)
+    {
+        uint64_t at = rnd() % values.size();
+        errors += reader.At( at ) != values[at];
+        time_tick_t window[100];
+        size_t got = reader.Decode( at, window, 100 );
+        for (size_t k = 0; k < got; k++)
+            errors += window[k] != values[at + k];
+    }
+
+    cout << name << (dod ? " (delta of delta)" : "") << ": " << double( bytes.size() ) / values.size() << " bytes/value, decode "
+        << spent.asMicroSec() * 1000 / values.size() << " ns/value, errors: " << errors << endl;
+    return errors;
+}
+
+int main()
+{
+    const size_t N = 1000000;
+    mt19937_64 rnd( 42 );
+
+    // 60 Hz frame stamps with scheduling jitter
+    vector<time_tick_t> frames( N );
+    time_tick_t t = ProgramTime().getTicks();
+    normal_distribution<double> jitter( 0, 50000 );
+    for (size_t i = 0; i < N; i++)
+        frames[i] = t + time_tick_t( i ) * (TICKS_PER_SEC / 60) + time_tick_t( jitter( rnd ) );
+
+    // irregular network events: increasing with exponential gaps
+    vector<time_tick_t> events( N );
+    exponential_distribution<double> gap( 1. / 200000 );
+    for (size_t i = 0; i < N; i++)
+        events[i] = t += time_tick_t( gap( rnd ) );
+
+    // extremes and decreasing values
+    vector<time_tick_t> extremes = { MAX_TICK, MIN_TICK, 0, -1, 1, MAX_TICK, MAX_TICK - 1, MIN_TICK };
+    for (int i = 0; i < 1000; i++)
+        extremes.push_back( time_tick_t( rnd() ) );
+
+    // regular ticks of a fixed step
+    vector<time_tick_t> steps( N );
+    for (size_t i = 0; i < N; i++)
+        steps[i] = time_tick_t( i ) * (TICKS_PER_SEC / 60);
+
+    long long errors = 0;
+    for (bool dod : { false, true })
+    {
+        errors += roundTrip( "frames", frames, dod );
+        errors += roundTrip( "events", events, dod );
+        errors += roundTrip( "extremes", extremes, dod );
+        errors += roundTrip( "steps", steps, dod );
+    }
+
+    // malformed streams are rejected
+    TimeStreamWriter writer;
+    writer.Append( frames.data(), 1000 );
+    vector<uint8_t> broken = writer.Finish();
+    broken.resize( broken.size() - 1 );
+    TimeStreamReader reader;
+    cout << "truncated stream rejected: " << !reader.Open( broken ) << " (expected 1)" << endl;
+
+    // hostile trailer: 2^40 values in 2^40 blocks of one, no data at all
+    vector<uint8_t> hostile = { 'P', 'T', 'S', 1, 0, 1 };
+    _varint_put( hostile, uint64_t( 1 ) << 40 );  // amount of blocks in the index
+    for (int i = 0; i < 8; i++)
+        hostile.push_back( uint8_t( (uint64_t( 1 ) << 40) >> (8 * i) ) );  // Count
+    for (int i = 0; i < 8; i++)
+        hostile.push_back( uint8_t( i ? 0 : 6 ) );  // IndexOffset
+    hostile.insert( hostile.end(), { 'P', 'T', 'S', 'I' } );
+    cout << "hostile counts rejected: " << !reader.Open( hostile ) << " (expected 1)" << endl;
+    cout << "total errors: " << errors << " (expected 0)" << endl;
+    return 0;
+}
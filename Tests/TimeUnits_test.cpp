@@ -0,0 +1,52 @@
+/*
+ * Simple test for TimeUnits.hpp::UnitDuration - lossless and lossy unit
+ * conversions, interoperation with Duration and compile-time evaluation
+ */
+
+#include <iostream>
+#include <type_traits>
+using namespace std;
+
+#include "TimeUnits.hpp"
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+// conversions are resolved at compile time
+static_assert( MicroSec( MilliSec( 3 ) ).count() == 3000, "lossless conversion must be exact" );
+static_assert( unit_cast<Sec>( MilliSec( 2999 ) ).count() == 2, "unit_cast truncates" );
+static_assert( unit_cast<Sec>( MilliSec( -2999 ) ).count() == -2, "unit_cast truncates towards zero" );
+static_assert( MilliSec( 1500 ) > Sec( 1 ), "comparison of mixed units goes through the common unit" );
+static_assert( !is_convertible<MilliSec, Sec>::value, "lossy conversion must be explicit" );
+static_assert( is_convertible<Sec, MilliSec>::value, "lossless conversion is implicit" );
+static_assert( is_convertible<MilliSec, RealSec>::value, "conversion into real units is implicit" );
+static_assert( sizeof( MicroSec ) == sizeof( time_int64_t ), "no storage beyond the count" );
+
+int main()
+{
+    cout << "3 ms in us: " << MicroSec( MilliSec( 3 ) ).count() << " (expected 3000)" << endl;
+    cout << "2999 ms in s: " << unit_cast<Sec>( MilliSec( 2999 ) ).count() << " (expected 2)" << endl;
+    cout << "-2999 ms in s: " << unit_cast<Sec>( MilliSec( -2999 ) ).count() << " (expected -2)" << endl;
+    cout << "1500 ms in real s: " << RealSec( MilliSec( 1500 ) ).count() << " (expected 1.5)" << endl;
+    cout << "2.5 real ms in us: " << unit_cast<MicroSec>( RealMilliSec( 2.5 ) ).count() << " (expected 2500)" << endl;
+
+    // algebra stays in the unit
+    MilliSec frame( 16 );
+    frame += MilliSec( 1 );
+    cout << "17 ms * 3: " << (frame * 3).count() << "\t17 ms / 2: " << (frame / 2).count()
+        << "\t100 ms / 17 ms: " << MilliSec( 100 ) / frame << "\t100 ms % 17 ms: " << (MilliSec( 100 ) % frame).count()
+        << " (expected 51 8 5 15)" << endl;
+
+    // round trip through Duration
+    Duration d = MilliSec( 250 );
+    cout << "250 ms as Duration: " << d.asMilliSec() << " ms (expected 250)" << endl;
+    cout << "back in ms: " << MilliSec( d ).count() << "\tin us: " << MicroSec( d ).count() << " (expected 250 250000)" << endl;
+    cout << "1.9 ms Duration in ms: " << unit_cast<MilliSec>( microsec( 1900 ) ).count() << " (expected 1)" << endl;
+    cout << "1 s Duration in ticks: " << Duration( Sec( 1 ) ).getTicks() << " (expected " << TICKS_PER_SEC << ")" << endl;
+
+    // Duration consumers accept unit-typed intervals as is
+    ElementaryTimer t;
+    Sleep( MilliSec( 20 ) );
+    MilliSec slept( t.GetTime() );
+    cout << "slept: " << slept.count() << " ms (expected ~20)" << endl;
+    return 0;
+}
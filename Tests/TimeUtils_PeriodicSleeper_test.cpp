@@ -0,0 +1,60 @@
+/*
+ * Simple test for TimeUtils.hpp::PreciseSleep() and PeriodicSleeper - wake-up
+ * accuracy, pacing on absolute deadlines, skipped periods and bad periods
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+int main()
+{
+    // precise sleep is never early and late by much less than a kernel sleep
+    CalibrateSleepSpinThreshold();
+    Duration early = ZERO_Duration;
+    vector<time_real_t> late;
+    for (int i = 0; i < 50; i++)
+    {
+        Duration start = ProgramTime();
+        PreciseSleep( millisec( 1 ) );
+        Duration d = ProgramTime() - start - millisec( 1 );
+        early = min( early, d );
+        late.push_back( d.asMicroSec() );
+    }
+    sort( late.begin(), late.end() );  // median: preemption on a busy machine only hits single sleeps
+    cout << "PreciseSleep early by: " << (ZERO_Duration - early).asMicroSec() << " us (expected 0)\tmedian late by: " << late[25] << " us (expected a few)" << endl;
+
+    // 240 Hz loop: 120 iterations take 0.5 s regardless of the work inside
+    PeriodicSleeper pacer( seconds( 1.0 / 240 ) );
+    vector<time_real_t> lateness;
+    Duration start = ProgramTime();
+    for (int i = 0; i < 120; i++)
+    {
+        ElementaryTimer work;
+        while (work.GetTime() < millisec( 1 ))
+            ;
+        pacer.Wait();
+        lateness.push_back( pacer.GetLateness().asMicroSec() );
+    }
+    sort( lateness.begin(), lateness.end() );
+    cout << "120 periods: " << (ProgramTime() - start).asMilliSec() << " ms (expected ~500)\tmedian lateness: " << lateness[60] << " us\toverruns: " << pacer.GetOverruns() << " (expected 0)" << endl;
+
+    // a slow iteration skips the missed periods instead of a catch-up burst
+    uint64_t before = pacer.GetOverruns();
+    Sleep( seconds( 3.5 / 240 ) );
+    bool inTime = pacer.Wait();
+    cout << "after 3.5 periods of work: in time " << inTime << " (expected 0)\tskipped: " << pacer.GetOverruns() - before << " (expected 3 or 4)" << endl;
+    cout << "next deadline ahead: " << (pacer.GetNext() > ProgramTime()) << " (expected 1)" << endl;
+
+    // periods <= 0 are clamped: Wait doesn't divide by zero
+    PeriodicSleeper zero( ZERO_Duration );
+    zero.Wait();
+    zero.SetPeriod( ZERO_Duration - millisec( 1 ) );
+    zero.Wait();
+    cout << "bad period clamped to: " << zero.GetPeriod().getTicks() << " ticks (expected 1)" << endl;
+    return 0;
+}
@@ -12,24 +12,23 @@ int main()
 {
     cout << "\nTPS: " << TICKS_PER_SEC << endl;
 
-    Duration stime = ProgramTime(), ms = millisec( 1 ), s = seconds( 1 );
-    Duration ctime = stime, t = ctime;
+    Duration ms = millisec( 1 ), s = seconds( 1 );
 
     Perspective::ElementaryTimer ET;
     Repeater<ElementaryTimer> R( &ET, s );
 
-    while (1)
+    int repeats = 0;
+    while (repeats < 3)  // three periods, then exit
     {
         while (R.check())
         {
-            cout << ProgramTime().clocks() << endl;
-            //ctime +=s;
+            cout << ProgramTime().getTicks() << endl;
             R.repeat();
+            repeats++;
         }
 
         Sleep( ms );
     }
 
-    cin.get();
     return 0;
 }
\ No newline at end of file
@@ -3,17 +3,18 @@
  */
 
 #include <iostream>
+#include <thread>
 using namespace std;
 
 #include "TimeUtils.hpp"
 using namespace Perspective;
 
-Duration ms = millisec( 1 ), s = seconds( 1 );
+Duration ms = millisec( 1 ), s = seconds( 1 ), runtime = seconds( 3 );
 
 void foo1( int id )
 {
     Duration p = seconds( 0.2 ), t, l = ProgramTime();
-    while (1)
+    while (ProgramTime() < runtime)
     {
         if ((t = ProgramTime()) > l + p)
         {
@@ -27,7 +28,7 @@ void foo1( int id )
 void foo2( int id )
 {
     Duration p = seconds( 0.5 ), t, l = ProgramTime();
-    while (1)
+    while (ProgramTime() < runtime)
     {
         if ((t = ProgramTime()) > l + p)
         {
@@ -43,16 +44,18 @@ int main()
     std::thread first( foo1, 1 );
     std::thread seconf( foo2, 2 );
 
-    Duration l = ProgramTime();
-    while (1)
+    Duration T, l = ProgramTime();
+    while (ProgramTime() < runtime)
     {
         if ((T = ProgramTime()) > l + s)
         {
-            cout << 0 << "\t" << ProgramTime() << endl;
+            cout << 0 << "\t" << (time_real_t)ProgramTime() << endl;
             l += s;
         }
         Sleep( ms );
     }
 
+    first.join();
+    seconf.join();
     return 0;
 }
\ No newline at end of file
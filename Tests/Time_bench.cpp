@@ -0,0 +1,238 @@
+/*
+ * Non-interactive benchmark of Core time primitives.
+ * Every case runs warm-up and R repetitions of N operations, reports per
+ * operation statistics (median, mean, stddev, min, max, 95% CI of mean) and
+ * writes JSON for comparison across builds and machines.
+ *
+ * Usage: Time_bench [output.json] [repetitions]
+ * Build: g++ -O2 -std=c++17 -I../Core Time_bench.cpp ../Core/Timer.cpp ../Core/TimeUtils.cpp ../Core/TimeFormat.cpp ../Core/TimeHistogram.cpp -pthread
+ *        (add -DPER_TIME_TSC to benchmark the TSC backend)
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+using namespace std;
+
+#include "TimeUtils.hpp"
+#include "TimeFormat.hpp"
+#include "TimeHistogram.hpp"
+using namespace Perspective;
+
+// ----------------------------- Harness ------------------------------------
+
+// keeps the compiler from removing benchmarked computations
+template<class T>
+inline void keep( const T& v )
+{
+#if defined(__GNUC__)
+    asm volatile( "" : : "g"( &v ) : "memory" );
+#else
+    static volatile const void* sink;
+    sink = &v;
+#endif
+}
+
+struct Result
+{
+    string name;
+    string unit;  // unit of samples
+    int64_t ops;  // operations per repetition
+    vector<double> samples;  // per operation value of every repetition
+};
+
+// summary of samples
+struct Stats
+{
+    double median, mean, stddev, min, max, ci95;
+};
+
+Stats summarize( vector<double> v )
+{
+    Stats s{};
+    sort( v.begin(), v.end() );
+    size_t n = v.size();
+    s.min = v.front();
+    s.max = v.back();
+    s.median = n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    for (double x : v)
+        s.mean += x;
+    s.mean /= n;
+    for (double x : v)
+        s.stddev += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? sqrt( s.stddev / (n - 1) ) : 0;
+    s.ci95 = 1.96 * s.stddev / sqrt( double( n ) );
+    return s;
+}
+
+int repetitions = 30;
+vector<Result> results;
+
+// measures per-op nanoseconds of Body( i ) repeated Ops times
+template<class Body>
+void bench( const string& name, int64_t ops, Body body )
+{
+    Result r{ name, "ns/op", ops, {} };
+    for (int64_t i = 0; i < ops / 10; i++)  // warm-up
+        body( i );
+    for (int rep = 0; rep < repetitions; rep++)
+    {
+        auto start = std::chrono::steady_clock::now();  // independent of the measured clocks
+        for (int64_t i = 0; i < ops; i++)
+            body( i );
+        auto spent = std::chrono::steady_clock::now() - start;
+        r.samples.push_back( std::chrono::duration<double, std::nano>( spent ).count() / ops );
+    }
+    Stats s = summarize( r.samples );
+    cout << name << ": " << s.median << " ns/op (+-" << s.ci95 << ")" << endl;
+    results.push_back( r );
+}
+
+// measures wake-up error in microseconds of Sleeper( request )
+template<class Sleeper>
+void sleepAccuracy( const string& name, const Duration& request, Sleeper sleeper )
+{
+    Result r{ name, "us late", 1, {} };
+    for (int rep = 0; rep < repetitions; rep++)
+    {
+        Duration start = ProgramTime();
+        sleeper( request );
+        r.samples.push_back( (ProgramTime() - start - request).asMicroSec() );
+    }
+    Stats s = summarize( r.samples );
+    cout << name << ": " << s.median << " us late (max " << s.max << ")" << endl;
+    results.push_back( r );
+}
+
+// measures wake-up lateness in microseconds of a 240 Hz PeriodicSleeper loop
+void periodicLateness( const string& name, bool precise )
+{
+    Result r{ name, "us late", 1, {} };
+    PeriodicSleeper sleeper( seconds( 1.0 / 240 ), precise );
+    for (int rep = 0; rep < repetitions; rep++)
+    {
+        sleeper.Wait();
+        r.samples.push_back( sleeper.GetLateness().asMicroSec() );
+    }
+    Stats s = summarize( r.samples );
+    cout << name << ": " << s.median << " us late (max " << s.max << ", overruns " << sleeper.GetOverruns() << ")" << endl;
+    results.push_back( r );
+}
+
+// ------------------------------ Output ------------------------------------
+
+string backend()
+{
+#if defined(PER_TIME_WINDOWS_QPC)
+    return "windows_qpc";
+#elif defined(PER_TIME_TSC)
+    return IsTSCActive() ? "tsc" : "tsc_fallback_steady_clock";
+#else
+    return "steady_clock";
+#endif
+}
+
+string compiler()
+{
+    ostringstream s;
+#if defined(__clang__)
+    s << "clang " << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+    s << "gcc " << __GNUC__ << "." << __GNUC_MINOR__;
+#elif defined(_MSC_VER)
+    s << "msvc " << _MSC_VER;
+#else
+    s << "unknown";
+#endif
+    return s.str();
+}
+
+void writeJson( ostream& out )
+{
+    char stamp[ISO8601_BUFFER_SIZE];
+    FormatISO8601( GlobalTime(), stamp, sizeof( stamp ), 0, true );
+
+    out << "{\n";
+    out << "  \"timestamp\": \"" << stamp << "\",\n";
+    out << "  \"compiler\": \"" << compiler() << "\",\n";
+    out << "  \"backend\": \"" << backend() << "\",\n";
+    out << "  \"ticks_per_sec\": " << TICKS_PER_SEC << ",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"repetitions\": " << repetitions << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        Stats s = summarize( r.samples );
+        out << "    { \"name\": \"" << r.name << "\", \"unit\": \"" << r.unit << "\", \"ops\": " << r.ops
+            << ", \"median\": " << s.median << ", \"mean\": " << s.mean << ", \"stddev\": " << s.stddev
+            << ", \"min\": " << s.min << ", \"max\": " << s.max << ", \"ci95\": " << s.ci95 << ", \"samples\": [";
+        for (size_t j = 0; j < r.samples.size(); j++)
+            out << (j ? ", " : "") << r.samples[j];
+        out << "] }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// ------------------------------- Cases ------------------------------------
+
+int main( int argc, char** argv )
+{
+    if (argc > 2)
+        repetitions = max( 2, atoi( argv[2] ) );
+
+    const int64_t N = 1000000;
+
+    // clocks
+    bench( "ProgramTime", N, []( int64_t ) { Duration d = ProgramTime(); keep( d ); } );
+    bench( "ProgramTimeCoarse", N, []( int64_t ) { Duration d = ProgramTimeCoarse(); keep( d ); } );
+    bench( "SystemTime", N, []( int64_t ) { Time t = SystemTime(); keep( t ); } );
+    bench( "GlobalTime", N, []( int64_t ) { Time t = GlobalTime(); keep( t ); } );
+    bench( "ThreadCPUTime", N / 10, []( int64_t ) { Duration d = ThreadCPUTime(); keep( d ); } );
+
+    // timers
+    Timer timer;
+    timer.Start();
+    bench( "Timer::Update", N, [&]( int64_t ) { keep( timer.Update() ); } );
+    bench( "Timer::Start+Stop", N, [&]( int64_t ) { timer.Start(); keep( timer.Stop() ); } );
+    StopwatchTimer<> stopwatch;
+    stopwatch.Start();
+    bench( "StopwatchTimer::Update", N, [&]( int64_t ) { keep( stopwatch.Update() ); } );
+    bench( "FrameClock::Tick", N, []( int64_t ) { keep( FrameClock::Tick() ); } );
+    LatencyHistogram histogram;
+    bench( "LatencyHistogram::Record", N, [&]( int64_t i ) { histogram.Record( Duration( i * 977 ) ); } );
+
+    // Duration conversions of varying values
+    const int64_t M = 10000000;
+    bench( "Duration::asMicroSec", M, []( int64_t i ) { time_real_t v = Duration( i * 977 ).asMicroSec(); keep( v ); } );
+    bench( "Duration::asMicroSecFast", M, []( int64_t i ) { time_real_t v = Duration( i * 977 ).asMicroSecFast(); keep( v ); } );
+    bench( "Duration::asMilliSec", M, []( int64_t i ) { time_real_t v = Duration( i * 977 ).asMilliSec(); keep( v ); } );
+    bench( "Duration::asMilliSecInt", M, []( int64_t i ) { time_int_t v = Duration( i * 977 ).asMilliSecInt(); keep( v ); } );
+    bench( "Duration::asSec", M, []( int64_t i ) { time_real_t v = Duration( i * 977 ).asSec(); keep( v ); } );
+    bench( "MicroSec(Duration)", M, []( int64_t i ) { MicroSec v( Duration( i * 977 ) ); keep( v ); } );
+    bench( "MilliSec(Duration)", M, []( int64_t i ) { MilliSec v( Duration( i * 977 ) ); keep( v ); } );
+
+    // sleep accuracy
+    sleepAccuracy( "Sleep(1ms)", millisec( 1 ), []( const Duration& d ) { Sleep( d ); } );
+    sleepAccuracy( "SleepUntil(1ms)", millisec( 1 ), []( const Duration& d ) { SleepUntil( ProgramTime() + d ); } );
+    CalibrateSleepSpinThreshold();
+    sleepAccuracy( "PreciseSleep(1ms)", millisec( 1 ), []( const Duration& d ) { PreciseSleep( d ); } );
+    periodicLateness( "PeriodicSleeper(240Hz)", false );
+    periodicLateness( "PeriodicSleeper(240Hz,precise)", true );
+
+    if (argc > 1)
+    {
+        ofstream file( argv[1] );
+        writeJson( file );
+        cout << "results written to " << argv[1] << endl;
+    }
+    else
+        writeJson( cout );
+    return 0;
+}
@@ -1,20 +1,22 @@
 /* 
- * Simple test for Time.hpp
+ * Simple test for Timer.hpp: Time, Duration and clocks
  */
 
 #include <iostream>
+#include <cstdlib>  // atoll
 using namespace std;
 
-#include "Time.hpp"
+#include "Timer.hpp"
 using namespace Perspective;
 
-int main()
+int main( int argc, char** argv )
 {
-    std::cout << "Start moment: " << StartMoment.as_c_str() << endl << endl;
+    Duration first = ProgramTime();  // the first clock reading of the process takes the start anchor
+    std::cout << "first ProgramTime() >= 0: " << (first >= ZERO_Duration) << " (expected 1)" << endl;
+    std::cout << "Start moment: " << StartMoment().as_c_str() << endl << endl;
 
-    int64_t a = 0, b;
-    std::cout << "enter amount of loops:   ";
-    std::cin >> b;
+    int64_t a = 0, b = argc > 1 ? atoll( argv[1] ) : 100000000;
+    std::cout << "amount of loops:   " << b << endl;
     std::cout << "calculating...\n";
 
     Time t1 = SystemTime();
@@ -27,17 +29,17 @@ int main()
     Duration dt2 = ProgramTime();
     Duration deltatime( dt2 - dt1 );
 
-    std::cout << "dt=deltatime:  " << deltatime << std::endl;
+    std::cout << "dt=deltatime:  " << (time_real_t)deltatime << std::endl;
+    std::cout << "sum:           " << a << std::endl;
     std::cout << "dt(millisec):  " << deltatime.asMilliSec() << std::endl;
     std::cout << "System time 1: " << t1.as_c_str() << std::endl;
     std::cout << "System time 2: " << t2.as_c_str() << std::endl;
-    std::cout << "SysT2 - SysT1: " << t2 - t1 << std::endl;
+    std::cout << "SysT2 - SysT1: " << (time_real_t)(t2 - t1) << std::endl;
     std::cout << "SysT2 + 10*dt: " << (t2 + 10. * deltatime).as_c_str() << std::endl << std::endl;
     std::cout << "dt1 (clocks) : " << dt1.getTicks() << std::endl;
     std::cout << "dt2 (clocks) : " << dt2.getTicks() << std::endl;
     std::cout << "SysT1(clocks): " << t1.getTicks() << std::endl;
     std::cout << "SysT2(clocks): " << t2.getTicks() << std::endl;
 
-    std::cin.get();
-    std::cin.get();
+    return (t2 >= t1 && dt2 >= dt1) ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+ * Simple test for TimeUtils.hpp::TimingWheel - compares expirations with
+ * brute force and measures schedule/expire cost
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+using namespace std;
+
+#include "TimeUtils.hpp"
+using namespace Perspective;
+
+int main()
+{
+    const Duration gran = millisec( 1 );
+    const int N = 200000;
+
+    // virtual time: the wheel is driven by explicit moments
+    Duration now = ZERO_Duration;
+    TimingWheel wheel( gran, now );
+    wheel.Reserve( N );
+
+    std::mt19937_64 rnd( 42 );
+    vector<Duration> deadline( N );
+    vector<bool> fired( N, false ), canceled( N, false );
+    vector<TimingWheel::TimerId> ids( N );
+    for (int i = 0; i < N; i++)
+    {
+        // from sub-tick to ~30 hours - all wheel levels and cascades
+        deadline[i] = Duration( time_tick_t( rnd() % (TICKS_PER_SEC * 100000) ) >> (rnd() % 24) );
+        ids[i] = wheel.ScheduleAt( deadline[i], i );
+    }
+    for (int i = 0; i < N; i += 7)
+        canceled[i] = wheel.Cancel( ids[i] );
+
+    long long errors = 0, expired = 0;
+    Duration step = millisec( 1 );
+    while (wheel.Size())
+    {
+        now += step;
+        step = step * 1.01;  // growing steps exercise multi-tick advances
+        for (const TimingWheel::Expired& e : wheel.Advance( now ))
+        {
+            int i = int( e.UserData );
+            if (canceled[i] || fired[i] || deadline[i] > now || now - deadline[i] > step + gran)
+                errors++;
+            fired[i] = true;
+            expired++;
+        }
+    }
+    for (int i = 0; i < N; i++)
+        if (!canceled[i] && !fired[i])
+            errors++;
+    cout << "expired: " << expired << "\terrors: " << errors << endl;
+
+    // periodic timer fires once per period
+    TimingWheel periodic( gran, ZERO_Duration );
+    TimingWheel::TimerId p = periodic.SchedulePeriodicAt( millisec( 10 ), millisec( 10 ), 7 );
+    int calls = 0;
+    for (int ms = 1; ms <= 1000; ms++)
+        calls += int( periodic.Advance( millisec( ms ), []( TimingWheel::TimerId, uint64_t ) {} ) );
+    cout << "periodic calls in 1 s: " << calls << "\tcanceled: " << periodic.Cancel( p ) << endl;
+
+    // cost of schedule + expire
+    TimingWheel bench( gran, ZERO_Duration );
+    bench.Reserve( 1000000 );
+    Duration start = ProgramTime();
+    for (int i = 0; i < 1000000; i++)
+        bench.ScheduleAt( millisec( i % 5000 ), i );
+    Duration scheduled = ProgramTime();
+    size_t total = 0;
+    for (int ms = 0; ms <= 5000; ms++)
+        total += bench.Advance( millisec( ms ) ).size();
+    Duration done = ProgramTime();
+    cout << "schedule: " << (scheduled - start).asMicroSec() / 1000. << " ns\texpire: "
+        << (done - scheduled).asMicroSec() / 1000. << " ns per timer (" << total << ")" << endl;
+    return 0;
+}